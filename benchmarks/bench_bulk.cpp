@@ -0,0 +1,79 @@
+//
+// Bulk allocation benchmark
+// ns/object for allocate+free of a batch, one-at-a-time vs *_bulk,
+// batch sizes 1..1024, for MemoryPool, SlabAllocator and SlabCache.
+//
+
+#include "alloc/memory_pool.hpp"
+#include "alloc/slab_allocator.hpp"
+#include "alloc/cache_slab_allocator.hpp"
+#include "bench_common.hpp"
+
+#include <cstdio>
+#include <vector>
+
+static constexpr std::size_t OBJECT_SIZE = 64;
+static constexpr std::size_t TOTAL_OBJECTS = 1 << 22;
+
+template <class Single, class Bulk>
+static void run(const char* name, std::size_t batch, Single single, Bulk bulk) {
+    std::vector<void*> ptrs(batch);
+    std::size_t rounds = TOTAL_OBJECTS / batch;
+
+    bench::Timer timer;
+    for (std::size_t r = 0; r < rounds; ++r)
+        single(ptrs.data(), batch);
+    double single_ns = timer.elapsed_ns() / double(rounds * batch);
+
+    timer.reset();
+    for (std::size_t r = 0; r < rounds; ++r)
+        bulk(ptrs.data(), batch);
+    double bulk_ns = timer.elapsed_ns() / double(rounds * batch);
+
+    std::printf("%-14s batch=%5zu  single=%6.2f ns/obj  bulk=%6.2f ns/obj\n",
+                name, batch, single_ns, bulk_ns);
+}
+
+int main() {
+    MemoryPool pool(OBJECT_SIZE, 1024);
+    SlabAllocator slab(1024);
+    SlabCache cache(OBJECT_SIZE, 1 << 16);
+
+    for (std::size_t batch = 1; batch <= 1024; batch *= 2) {
+        run("MemoryPool", batch,
+            [&](void** p, std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) p[i] = pool.allocate();
+                bench::do_not_optimize(p[0]);
+                for (std::size_t i = 0; i < n; ++i) pool.deallocate(p[i]);
+            },
+            [&](void** p, std::size_t n) {
+                pool.allocate_bulk(p, n);
+                bench::do_not_optimize(p[0]);
+                pool.deallocate_bulk(p, n);
+            });
+
+        run("SlabAllocator", batch,
+            [&](void** p, std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) p[i] = slab.allocate(OBJECT_SIZE);
+                bench::do_not_optimize(p[0]);
+                for (std::size_t i = 0; i < n; ++i) slab.deallocate(p[i], OBJECT_SIZE);
+            },
+            [&](void** p, std::size_t n) {
+                slab.allocate_bulk(OBJECT_SIZE, p, n);
+                bench::do_not_optimize(p[0]);
+                slab.deallocate_bulk(p, n, OBJECT_SIZE);
+            });
+
+        run("SlabCache", batch,
+            [&](void** p, std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) p[i] = cache.allocate();
+                bench::do_not_optimize(p[0]);
+                for (std::size_t i = 0; i < n; ++i) cache.deallocate(p[i]);
+            },
+            [&](void** p, std::size_t n) {
+                cache.allocate_bulk(p, n);
+                bench::do_not_optimize(p[0]);
+                cache.deallocate_bulk(p, n);
+            });
+    }
+}
@@ -0,0 +1,148 @@
+//
+// Cache layout benchmark
+// 1) False sharing  : threads bump counters in adjacent pool blocks
+// 2) Straddling     : random full-object reads of 48-byte objects
+// 3) Slab colouring : repeatedly touch the first object of many slabs
+//
+
+#include "alloc/memory_pool.hpp"
+#include "alloc/cache_slab_allocator.hpp"
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+static const char* layout_name(SlotLayout layout) {
+    switch (layout) {
+    case SlotLayout::Packed:       return "Packed";
+    case SlotLayout::NoStraddle:   return "NoStraddle";
+    case SlotLayout::CacheAligned: return "CacheAligned";
+    }
+    return "?";
+}
+
+struct Counter {
+    std::atomic<std::uint64_t> value;
+};
+
+static void false_sharing(SlotLayout layout, unsigned threads, std::uint64_t iters) {
+    MemoryPool pool(sizeof(Counter), 64, layout);
+
+    std::vector<Counter*> counters;
+    for (unsigned t = 0; t < threads; ++t)
+        counters.push_back(new (pool.allocate()) Counter{{0}});
+
+    bench::Timer timer;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([c = counters[t], iters] {
+            for (std::uint64_t i = 0; i < iters; ++i)
+                c->value.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    std::printf("false-sharing  %-12s threads=%u  %8.2f ms  (block=%zu)\n",
+                layout_name(layout), threads, timer.elapsed_ms(), pool.block_size());
+
+    for (Counter* c : counters) pool.deallocate(c);
+}
+
+struct Obj48 {
+    std::uint64_t words[6];
+};
+
+static void straddle(SlotLayout layout, std::size_t count, std::size_t reads) {
+    SlabCache cache(sizeof(Obj48), 1 << 16, nullptr, nullptr, layout);
+
+    std::vector<Obj48*> objs(count);
+    for (auto& o : objs) {
+        o = static_cast<Obj48*>(cache.allocate());
+        for (auto& w : o->words) w = 1;
+    }
+
+    std::mt19937 rng(42);
+    std::vector<std::uint32_t> order(reads);
+    for (auto& i : order) i = rng() % count;
+
+    bench::CacheCounters counters;
+    bench::Timer timer;
+    counters.start();
+
+    std::uint64_t sum = 0;
+    for (std::uint32_t i : order)
+        for (auto w : objs[i]->words) sum += w;
+
+    counters.stop();
+    bench::do_not_optimize(sum);
+
+    std::printf("straddle       %-12s slot=%zu  %8.2f ms", layout_name(layout),
+                cache.slot_size(), timer.elapsed_ms());
+    counters.print_suffix();
+    std::printf("\n");
+
+    for (auto* o : objs) cache.deallocate(o);
+}
+
+struct Header {
+    std::uint64_t hot;
+    char payload[1000 - sizeof(std::uint64_t)];
+};
+
+static void colouring(bool colour, std::size_t slabs, std::size_t rounds) {
+    const std::size_t slab_size = 16384;
+    SlabCache cache(sizeof(Header), slab_size, nullptr, nullptr,
+                    SlotLayout::Packed, colour);
+
+    // The first allocation from each fresh slab is its first slot
+    std::size_t per_slab = slab_size / sizeof(Header);
+    std::vector<Header*> all;
+    std::vector<Header*> heads;
+    for (std::size_t s = 0; s < slabs; ++s) {
+        for (std::size_t i = 0; i < per_slab; ++i) {
+            auto* h = static_cast<Header*>(cache.allocate());
+            h->hot = 1;
+            if (i == 0) heads.push_back(h);
+            all.push_back(h);
+        }
+    }
+
+    bench::CacheCounters counters;
+    bench::Timer timer;
+    counters.start();
+
+    std::uint64_t sum = 0;
+    for (std::size_t r = 0; r < rounds; ++r)
+        for (Header* h : heads) sum += h->hot;
+
+    counters.stop();
+    bench::do_not_optimize(sum);
+
+    std::printf("colouring      %-12s colours=%zu  %8.2f ms", colour ? "on" : "off",
+                cache.colours(), timer.elapsed_ms());
+    counters.print_suffix();
+    std::printf("\n");
+
+    for (auto* h : all) cache.deallocate(h);
+}
+
+int main() {
+    unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    if (threads > 8) threads = 8;
+
+    for (SlotLayout l : {SlotLayout::Packed, SlotLayout::CacheAligned})
+        false_sharing(l, threads, 20'000'000);
+
+    for (SlotLayout l : {SlotLayout::Packed, SlotLayout::NoStraddle})
+        straddle(l, 1 << 18, 1 << 22);
+
+    for (bool c : {false, true})
+        colouring(c, 512, 2000);
+
+    if (!bench::CacheCounters().available())
+        std::printf("(perf counters unavailable: timings only)\n");
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+//
+// Benchmark helpers
+// - Wall-clock timer
+// - Optional hardware cache counters via perf_event_open (Linux)
+// - do_not_optimize to keep results alive
+// - Resident set size probe
+//
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+template <class T>
+inline void do_not_optimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class Timer {
+public:
+    Timer() : start_(std::chrono::steady_clock::now()) {}
+
+    void reset() { start_ = std::chrono::steady_clock::now(); }
+
+    double elapsed_ns() const {
+        auto d = std::chrono::steady_clock::now() - start_;
+        return std::chrono::duration<double, std::nano>(d).count();
+    }
+
+    double elapsed_ms() const { return elapsed_ns() / 1e6; }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Resident set size of this process in bytes (0 if unknown)
+inline std::size_t rss_bytes() {
+#if defined(__linux__)
+    std::FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long size = 0, resident = 0;
+    int n = std::fscanf(f, "%lu %lu", &size, &resident);
+    std::fclose(f);
+    if (n != 2) return 0;
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+//
+// Cache miss counters (L1D read misses, last-level cache misses).
+// available() is false when the kernel or container forbids perf events;
+// callers then report timings only.
+//
+class CacheCounters {
+public:
+    CacheCounters() {
+#if defined(__linux__)
+        l1d_ = open_counter(PERF_TYPE_HW_CACHE,
+                            PERF_COUNT_HW_CACHE_L1D |
+                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        llc_ = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+
+    ~CacheCounters() {
+#if defined(__linux__)
+        if (l1d_ >= 0) close(l1d_);
+        if (llc_ >= 0) close(llc_);
+#endif
+    }
+
+    CacheCounters(const CacheCounters&) = delete;
+    CacheCounters& operator=(const CacheCounters&) = delete;
+
+    bool available() const { return l1d_ >= 0 || llc_ >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        for (int fd : {l1d_, llc_}) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        for (int fd : {l1d_, llc_})
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    }
+
+    std::uint64_t l1d_misses() const { return read_counter(l1d_); }
+    std::uint64_t llc_misses() const { return read_counter(llc_); }
+
+    // Appends " l1d_miss=... llc_miss=..." or nothing if unavailable
+    void print_suffix() const {
+        if (l1d_ >= 0) std::printf("  l1d_miss=%llu", (unsigned long long)l1d_misses());
+        if (llc_ >= 0) std::printf("  llc_miss=%llu", (unsigned long long)llc_misses());
+    }
+
+private:
+    int l1d_ = -1;
+    int llc_ = -1;
+
+#if defined(__linux__)
+    static int open_counter(std::uint32_t type, std::uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    static std::uint64_t read_counter(int fd) {
+#if defined(__linux__)
+        std::uint64_t value = 0;
+        if (fd >= 0 && read(fd, &value, sizeof(value)) == sizeof(value))
+            return value;
+#else
+        (void)fd;
+#endif
+        return 0;
+    }
+};
+
+} // namespace bench
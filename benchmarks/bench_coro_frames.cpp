@@ -0,0 +1,71 @@
+//
+// Coroutine frame allocation benchmark (C++20)
+// Millions of short tasks, each frame allocated and freed once:
+// 1) flat   : create, run and destroy one leaf task at a time
+// 2) nested : a parent awaits FANOUT children, each awaiting a leaf
+//             (strictly nested, so a stack resource fits)
+// Frame sources: global new (plain promise), the heap through the
+// mixin (header + virtual call overhead only), a recycling
+// PoolFrameResource and a StackFrameResource.
+//
+
+#include "alloc/coro_task.hpp"
+#include "bench_common.hpp"
+
+#include <cstdio>
+
+static constexpr int FLAT_TASKS = 4'000'000;
+static constexpr int NESTED_ROOTS = 500'000;
+static constexpr int FANOUT = 4;
+
+template <class TaskT>
+TaskT leaf(int x) {
+    co_return x + 1;
+}
+
+template <class TaskT>
+TaskT middle(int x) {
+    co_return co_await leaf<TaskT>(x) * 2;
+}
+
+template <class TaskT>
+TaskT root(int x) {
+    int sum = 0;
+    for (int i = 0; i < FANOUT; ++i)
+        sum += co_await middle<TaskT>(x + i);
+    co_return sum;
+}
+
+template <class TaskT>
+static void run(const char* name) {
+    bench::Timer timer;
+    long long sum = 0;
+    for (int i = 0; i < FLAT_TASKS; ++i)
+        sum += leaf<TaskT>(i).get();
+    double flat_ns = timer.elapsed_ns() / FLAT_TASKS;
+
+    timer.reset();
+    for (int i = 0; i < NESTED_ROOTS; ++i)
+        sum += root<TaskT>(i).get();
+    double nested_ns = timer.elapsed_ns() / (NESTED_ROOTS * (1 + 2 * FANOUT));
+
+    bench::do_not_optimize(sum);
+    std::printf("%-16s flat=%6.1f ns/task  nested=%6.1f ns/task\n", name, flat_ns, nested_ns);
+}
+
+int main() {
+    run<Task<int, DefaultFrameAllocation>>("operator new");
+    run<Task<int>>("heap via mixin");
+
+    {
+        PoolFrameResource pool;
+        FrameResourceScope scope(pool);
+        run<Task<int>>("pool buckets");
+    }
+
+    {
+        StackFrameResource stack(64 << 10);
+        FrameResourceScope scope(stack);
+        run<Task<int>>("stack");
+    }
+}
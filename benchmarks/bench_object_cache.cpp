@@ -0,0 +1,71 @@
+//
+// Object caching benchmark
+// Allocate / use / free cycles of an expensive-to-construct object:
+// - new / delete                 : construct + destroy every cycle
+// - MemoryPool + placement new   : construct + destroy every cycle
+// - TypedSlabCache               : constructed once per slot, reused
+//
+
+#include "alloc/memory_pool.hpp"
+#include "alloc/typed_slab_cache.hpp"
+#include "bench_common.hpp"
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+struct Connection {
+    std::mutex lock;
+    std::vector<char> buffer;
+    std::string peer;
+
+    Connection() : buffer(16 * 1024) { peer.reserve(64); }
+};
+
+static constexpr std::size_t LIVE = 64;
+static constexpr std::size_t CYCLES = 20000;
+
+template <class Alloc, class Free>
+static void run(const char* name, Alloc alloc, Free release) {
+    Connection* live[LIVE];
+
+    bench::Timer t;
+    for (std::size_t c = 0; c < CYCLES; ++c) {
+        for (auto& conn : live) {
+            conn = alloc();
+            std::lock_guard<std::mutex> g(conn->lock);
+            conn->buffer[c % conn->buffer.size()] = 1;
+            conn->peer.assign("10.0.0.1:443");
+        }
+        for (Connection* conn : live) release(conn);
+    }
+
+    std::printf("%-26s %8.1f ns/cycle\n", name, t.elapsed_ns() / double(CYCLES * LIVE));
+}
+
+int main() {
+#if defined(__GLIBC__)
+    // Freeing 64 buffers at the heap top otherwise makes glibc trim and
+    // re-fault it every cycle, which would swamp the constructor cost
+    mallopt(M_TRIM_THRESHOLD, 256 << 20);
+#endif
+
+    run("new / delete",
+        [] { return new Connection(); },
+        [](Connection* c) { delete c; });
+
+    MemoryPool pool(sizeof(Connection), 256);
+    run("MemoryPool + placement new",
+        [&] { return new (pool.allocate()) Connection(); },
+        [&](Connection* c) { c->~Connection(); pool.deallocate(c); });
+
+    TypedSlabCache<Connection> cache;
+    run("TypedSlabCache",
+        [&] { return cache.allocate(); },
+        [&](Connection* c) { cache.deallocate(c); });
+}
@@ -0,0 +1,186 @@
+//
+// Per-CPU slab cache benchmark
+// 1) Scaling: alloc/free throughput across 1..N threads,
+//    PerCpuSlabCache vs a mutex-guarded SlabCache.
+// 2) Oversubscription: many mostly idle threads; memory parked in
+//    per-CPU magazines vs per-thread magazines of the same size.
+//
+
+#include "alloc/cache_slab_allocator.hpp"
+#include "alloc/percpu_slab_cache.hpp"
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static constexpr std::size_t OBJECT_SIZE = 128;
+static constexpr std::size_t MAGAZINE = 64;
+
+// Shared SlabCache behind one mutex (the naive thread-safe baseline)
+class LockedSlabCache {
+public:
+    LockedSlabCache() : cache_(OBJECT_SIZE, 1 << 16) {}
+    void* allocate() { std::lock_guard<std::mutex> g(m_); return cache_.allocate(); }
+    void deallocate(void* p) { std::lock_guard<std::mutex> g(m_); cache_.deallocate(p); }
+private:
+    std::mutex m_;
+    SlabCache cache_;
+};
+
+// Per-thread magazines in front of a shared depot (the design we compare against)
+class PerThreadSlabCache {
+public:
+    PerThreadSlabCache() : depot_(OBJECT_SIZE, 1 << 16) {}
+
+    void* allocate() {
+        Local& l = local();
+        if (l.count == 0) {
+            std::lock_guard<std::mutex> g(m_);
+            l.count = depot_.allocate_bulk(l.objects, MAGAZINE / 2);
+        }
+        return l.objects[--l.count];
+    }
+
+    void deallocate(void* p) {
+        Local& l = local();
+        if (l.count == MAGAZINE) {
+            std::lock_guard<std::mutex> g(m_);
+            depot_.deallocate_bulk(l.objects, MAGAZINE / 2);
+            std::copy(l.objects + MAGAZINE / 2, l.objects + MAGAZINE, l.objects);
+            l.count -= MAGAZINE / 2;
+        }
+        l.objects[l.count++] = p;
+    }
+
+    std::size_t cached_objects() const { return cached_.load(); }
+    std::size_t slab_bytes() { std::lock_guard<std::mutex> g(m_); return depot_.slab_bytes(); }
+
+    // Called by each thread before it parks, to publish its magazine fill
+    void publish() { cached_ += local().count; }
+
+private:
+    struct Local {
+        PerThreadSlabCache* owner = nullptr;
+        std::size_t count = 0;
+        void* objects[MAGAZINE];
+
+        ~Local() {
+            if (owner && count) {
+                std::lock_guard<std::mutex> g(owner->m_);
+                owner->depot_.deallocate_bulk(objects, count);
+            }
+        }
+    };
+
+    Local& local() {
+        thread_local Local l;
+        l.owner = this;
+        return l;
+    }
+
+    std::mutex m_;
+    SlabCache depot_;
+    std::atomic<std::size_t> cached_{0};
+};
+
+template <class Cache>
+static double throughput(Cache& cache, unsigned threads, std::size_t ops_per_thread) {
+    std::vector<std::thread> workers;
+    bench::Timer t;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back([&] {
+            void* held[16];
+            for (std::size_t n = 0; n < ops_per_thread; n += 16) {
+                for (auto& p : held) p = cache.allocate();
+                for (void* p : held) cache.deallocate(p);
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    return double(threads) * ops_per_thread / (t.elapsed_ns() / 1e3);   // Mops/s
+}
+
+// Run `threads` threads that each touch a few objects, then park
+template <class Cache, class Publish>
+static void park_threads(Cache& cache, unsigned threads, Publish publish,
+                         std::size_t& cached, std::size_t& slab_bytes,
+                         std::function<std::size_t()> count_cached) {
+    std::mutex m;
+    std::condition_variable cv;
+    unsigned parked = 0;
+    bool release = false;
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back([&] {
+            void* held[MAGAZINE / 2 + 8];
+            for (auto& p : held) p = cache.allocate();
+            for (void* p : held) cache.deallocate(p);
+            publish();
+
+            std::unique_lock<std::mutex> lock(m);
+            ++parked;
+            cv.notify_all();
+            cv.wait(lock, [&] { return release; });
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return parked == threads; });
+    }
+
+    cached = count_cached();
+    slab_bytes = cache.slab_bytes();
+
+    {
+        std::lock_guard<std::mutex> lock(m);
+        release = true;
+    }
+    cv.notify_all();
+    for (auto& w : workers) w.join();
+}
+
+int main() {
+    unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    const std::size_t ops = 1 << 20;
+
+    std::printf("PerCpuSlabCache: %zu CPUs, current CPU %u\n",
+                PerCpuSlabCache(OBJECT_SIZE).cpu_count(), PerCpuSlabCache::current_cpu());
+
+    for (unsigned t = 1; t <= max_threads; t *= 2) {
+        LockedSlabCache locked;
+        PerCpuSlabCache percpu(OBJECT_SIZE, 1 << 16, nullptr, nullptr, MAGAZINE);
+        PerThreadSlabCache perthread;
+
+        std::printf("threads=%3u  mutex=%6.2f  per-cpu=%6.2f  per-thread=%6.2f  Mops/s\n", t,
+                    throughput(locked, t, ops),
+                    throughput(percpu, t, ops),
+                    throughput(perthread, t, ops));
+    }
+
+    const unsigned idle_threads = 256;
+    std::size_t cached = 0, slab = 0;
+
+    {
+        PerCpuSlabCache percpu(OBJECT_SIZE, 1 << 16, nullptr, nullptr, MAGAZINE);
+        park_threads(percpu, idle_threads, [] {}, cached, slab,
+                     [&] { return percpu.cached_objects(); });
+        std::printf("idle threads=%u  per-cpu     cached=%6zu objs (%7.1f KiB)  slabs=%7.1f KiB\n",
+                    idle_threads, cached, cached * OBJECT_SIZE / 1024.0, slab / 1024.0);
+    }
+
+    {
+        PerThreadSlabCache perthread;
+        park_threads(perthread, idle_threads, [&] { perthread.publish(); }, cached, slab,
+                     [&] { return perthread.cached_objects(); });
+        std::printf("idle threads=%u  per-thread  cached=%6zu objs (%7.1f KiB)  slabs=%7.1f KiB\n",
+                    idle_threads, cached, cached * OBJECT_SIZE / 1024.0, slab / 1024.0);
+    }
+}
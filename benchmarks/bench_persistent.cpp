@@ -0,0 +1,115 @@
+//
+// Persistent arena benchmark
+// Startup cost of a read-mostly string index:
+// 1) Rebuild   : insert every key into std::unordered_map / an
+//                offset_hash_map in a MonotonicAllocator (today's startup)
+// 2) Snapshot  : one-time build into a file-backed PersistentArena + msync
+// 3) Map       : open the snapshot read-only and answer the first query,
+//                warm and (Linux) with the file evicted from the page cache
+// 4) Scan      : look up every key once on the mapped index
+//
+
+#include "alloc/persistent_arena.hpp"
+#include "alloc/offset_containers.hpp"
+#include "alloc/monotonic_allocator.hpp"
+#include "bench_common.hpp"
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static constexpr std::size_t KEYS = 1 << 20;
+
+using Index = offset_hash_map<offset_string, std::uint64_t>;
+
+static std::vector<std::string> make_keys() {
+    std::vector<std::string> keys(KEYS);
+    char buf[64];
+    for (std::size_t i = 0; i < KEYS; ++i) {
+        std::snprintf(buf, sizeof(buf), "instrument/%08zx/%zu", i * 2654435761u, i);
+        keys[i] = buf;
+    }
+    return keys;
+}
+
+template <class Arena>
+static Index* build(Arena& arena, const std::vector<std::string>& keys) {
+    Index* index = ::new (arena.allocate(sizeof(Index), alignof(Index))) Index();
+    index->reserve(arena, keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i)
+        index->insert(arena, offset_string(arena, keys[i]), i);
+    return index;
+}
+
+static void evict(const char* path) {
+#if defined(__linux__) && defined(POSIX_FADV_DONTNEED)
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+#else
+    (void)path;
+#endif
+}
+
+static void map_and_query(const char* label, const char* path, const std::vector<std::string>& keys) {
+    bench::Timer timer;
+    PersistentArena arena(path, PersistentArena::Mode::ReadOnly);
+    const Index* index = arena.root_as<Index>();
+    const std::uint64_t* first = index->find(keys[KEYS / 2]);
+    double first_ms = timer.elapsed_ms();
+    bench::do_not_optimize(first);
+
+    timer.reset();
+    std::uint64_t sum = 0;
+    for (const std::string& k : keys) sum += *index->find(k);
+    double scan_ms = timer.elapsed_ms();
+    bench::do_not_optimize(sum);
+
+    std::printf("map %-14s first-query=%9.3f ms  scan=%8.2f ms\n", label, first_ms, scan_ms);
+}
+
+int main() {
+    std::vector<std::string> keys = make_keys();
+    std::string path = "bench_persistent.arena";
+
+    {
+        bench::Timer timer;
+        std::unordered_map<std::string, std::uint64_t> map;
+        map.reserve(KEYS);
+        for (std::size_t i = 0; i < KEYS; ++i) map.emplace(keys[i], i);
+        std::printf("rebuild unordered_map       %9.2f ms\n", timer.elapsed_ms());
+        bench::do_not_optimize(map.size());
+    }
+
+    {
+        bench::Timer timer;
+        MonotonicAllocator arena(64 << 20);
+        Index* index = build(arena, keys);
+        std::printf("rebuild offset_hash_map     %9.2f ms\n", timer.elapsed_ms());
+        bench::do_not_optimize(index->size());
+    }
+
+    {
+        bench::Timer timer;
+        PersistentArena arena(path.c_str(), PersistentArena::Mode::Create, 256 << 20);
+        arena.set_root(build(arena, keys));
+        double build_ms = timer.elapsed_ms();
+        arena.sync();
+        std::printf("snapshot build+msync        %9.2f ms  (msync %.2f ms, %.1f MiB)\n",
+                    timer.elapsed_ms(), timer.elapsed_ms() - build_ms,
+                    double(arena.used()) / (1024.0 * 1024.0));
+    }
+
+    map_and_query("warm", path.c_str(), keys);
+    evict(path.c_str());
+    map_and_query("cold", path.c_str(), keys);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,147 @@
+//
+// Pipeline benchmark
+// A producer stage builds batches of ITEMS float vectors of random
+// length; two consumer stages read every batch concurrently (fan-out)
+// and the last one to finish frees it.
+// 1) new/delete        : items and batch from the global heap, freed
+//                        by whichever consumer drops the last reference
+// 2) GenerationalArena : batches built in a ring of K arenas,
+//                        released generation-wise, reused in place
+// Reports batches/s and resident memory.
+//
+
+#include "alloc/generational_arena.hpp"
+#include "bench_common.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+static constexpr std::size_t BATCHES = 20'000;
+static constexpr std::size_t ITEMS = 64;
+static constexpr std::size_t MAX_FLOATS = 1024;
+static constexpr std::size_t RING = 8;
+
+struct Item {
+    float* data;
+    std::size_t n;
+};
+
+struct Batch {
+    Item items[ITEMS];
+    std::atomic<int> refs;                          // new/delete variant only
+    GenerationalArena::Generation* gen;             // arena variant only
+};
+
+// Single-producer single-consumer pointer ring; waits by yielding
+class Ring {
+public:
+    void push(Batch* p) {
+        std::size_t h = head_.load(std::memory_order_relaxed);
+        while (h - tail_.load(std::memory_order_acquire) == RING) std::this_thread::yield();
+        slots_[h % RING] = p;
+        head_.store(h + 1, std::memory_order_release);
+    }
+
+    Batch* pop() {
+        std::size_t t = tail_.load(std::memory_order_relaxed);
+        while (t == head_.load(std::memory_order_acquire)) std::this_thread::yield();
+        Batch* p = slots_[t % RING];
+        tail_.store(t + 1, std::memory_order_release);
+        return p;
+    }
+
+private:
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    Batch* slots_[RING];
+};
+
+static void fill(Item& item) {
+    for (std::size_t i = 0; i < item.n; ++i) item.data[i] = float(i & 0xff);
+}
+
+static double consume(const Batch* b) {
+    double sum = 0;
+    for (const Item& item : b->items)
+        for (std::size_t i = 0; i < item.n; ++i) sum += item.data[i];
+    return sum;
+}
+
+template <class Produce, class Release>
+static void run(const char* name, Produce produce, Release release) {
+    Ring to_a, to_b;
+    std::size_t rss_before = bench::rss_bytes();
+
+    auto consumer = [&](Ring& in) {
+        double sum = 0;
+        for (std::size_t k = 0; k < BATCHES; ++k) {
+            Batch* b = in.pop();
+            sum += consume(b);
+            release(b);
+        }
+        bench::do_not_optimize(sum);
+    };
+
+    bench::Timer timer;
+    std::thread a(consumer, std::ref(to_a));
+    std::thread b(consumer, std::ref(to_b));
+
+    std::mt19937 rng(1);
+    for (std::size_t k = 0; k < BATCHES; ++k) {
+        Batch* batch = produce(rng);
+        to_a.push(batch);
+        to_b.push(batch);
+    }
+
+    a.join();
+    b.join();
+    double ms = timer.elapsed_ms();
+
+    std::printf("%-18s %8.0f batches/s  rss +%6.1f MiB\n", name, BATCHES / (ms / 1e3),
+                double(bench::rss_bytes() - rss_before) / (1024.0 * 1024.0));
+}
+
+int main() {
+    run("new/delete",
+        [](std::mt19937& rng) {
+            Batch* b = new Batch;
+            b->refs.store(2, std::memory_order_relaxed);
+            for (Item& item : b->items) {
+                item.n = 1 + rng() % MAX_FLOATS;
+                item.data = new float[item.n];
+                fill(item);
+            }
+            return b;
+        },
+        [](Batch* b) {
+            if (b->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+            for (Item& item : b->items) delete[] item.data;
+            delete b;
+        });
+
+    // Room for one full batch per generation
+    GenerationalArena arenas(sizeof(Batch) + ITEMS * (MAX_FLOATS * sizeof(float) + 64), 4);
+
+    run("GenerationalArena",
+        [&](std::mt19937& rng) {
+            GenerationalArena::Generation* g = arenas.acquire();
+            Batch* b = g->construct<Batch>();
+            b->gen = g;
+            for (Item& item : b->items) {
+                item.n = 1 + rng() % MAX_FLOATS;
+                item.data = static_cast<float*>(g->allocate(item.n * sizeof(float), alignof(float)));
+                fill(item);
+            }
+
+            // One reference per consumer, then drop the producer's own
+            g->retain(2);
+            g->release();
+            return b;
+        },
+        [](Batch* b) { b->gen->release(); });
+
+    std::printf("generations in use at exit: %zu of %zu\n", arenas.in_use(), arenas.generations());
+}
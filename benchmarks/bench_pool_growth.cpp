@@ -0,0 +1,132 @@
+//
+// Pool growth benchmark
+// 1) Latency of the first N allocations after the pool grows
+//    (each block is written once, as a real caller would),
+//    default chunks vs POOL_PREFAULT, with and without reserve()
+//    ahead of the measured run.
+// 2) Sequential iteration over pool-allocated objects in
+//    allocation order: fresh (bump-carved) vs churned free list.
+// 3) Allocate/free churn with and without POOL_PREFETCH.
+//
+
+#include "alloc/memory_pool.hpp"
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static constexpr std::size_t OBJECT_SIZE = 64;
+static constexpr std::size_t CHUNK_BLOCKS = 1 << 16;   // 4 MiB chunks
+
+struct Obj {
+    std::uint64_t key;
+    char payload[OBJECT_SIZE - sizeof(std::uint64_t)];
+};
+
+static void first_allocations(const char* name, unsigned flags, std::size_t n, bool reserve) {
+    MemoryPool pool(OBJECT_SIZE, CHUNK_BLOCKS, SlotLayout::Packed, flags);
+
+    // Exhaust the initial chunk so the measured run starts with growth
+    std::vector<void*> warm(CHUNK_BLOCKS);
+    pool.allocate_bulk(warm.data(), warm.size());
+
+    // Growth moved off the hot path: paid once here, outside the timings
+    double reserve_us = 0;
+    if (reserve) {
+        bench::Timer t;
+        pool.reserve(n);
+        reserve_us = t.elapsed_ns() / 1e3;
+    }
+
+    std::vector<double> lat(n);
+    std::vector<void*> ptrs(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        bench::Timer t;
+        void* p = pool.allocate();
+        std::memset(p, 0xab, OBJECT_SIZE);
+        lat[i] = t.elapsed_ns();
+        ptrs[i] = p;
+    }
+
+    double total = 0;
+    for (double l : lat) total += l;
+    std::sort(lat.begin(), lat.end());
+
+    std::printf("first-%zu  %-16s total=%8.1f us  p50=%5.0f ns  p99=%6.0f ns  max=%8.0f ns",
+                n, name, total / 1e3, lat[n / 2], lat[n * 99 / 100], lat[n - 1]);
+    if (reserve) std::printf("  (reserve=%.1f us)", reserve_us);
+    std::printf("\n");
+}
+
+static double iterate(const std::vector<Obj*>& objs, int rounds) {
+    bench::Timer t;
+    std::uint64_t sum = 0;
+    for (int r = 0; r < rounds; ++r)
+        for (Obj* o : objs) sum += o->key;
+    bench::do_not_optimize(sum);
+    return t.elapsed_ns() / double(objs.size() * rounds);
+}
+
+static void locality(std::size_t n) {
+    std::mt19937 rng(7);
+
+    // Fresh pool: objects come off the bump pointer in address order
+    MemoryPool fresh(sizeof(Obj), CHUNK_BLOCKS);
+    std::vector<Obj*> a(n);
+    for (auto& o : a) { o = static_cast<Obj*>(fresh.allocate()); o->key = 1; }
+
+    // Churned pool: same objects, but the free list was scrambled first
+    MemoryPool churned(sizeof(Obj), CHUNK_BLOCKS);
+    std::vector<void*> tmp(n);
+    churned.allocate_bulk(tmp.data(), n);
+    std::shuffle(tmp.begin(), tmp.end(), rng);
+    for (void* p : tmp) churned.deallocate(p);
+    std::vector<Obj*> b(n);
+    for (auto& o : b) { o = static_cast<Obj*>(churned.allocate()); o->key = 1; }
+
+    std::printf("iterate  fresh (bump)     %5.2f ns/obj\n", iterate(a, 10));
+    std::printf("iterate  churned freelist %5.2f ns/obj\n", iterate(b, 10));
+}
+
+static void churn(const char* name, unsigned flags, std::size_t live, std::size_t ops) {
+    std::mt19937 rng(11);
+    MemoryPool pool(sizeof(Obj), CHUNK_BLOCKS, SlotLayout::Packed, flags);
+
+    std::vector<void*> slots(live);
+    pool.allocate_bulk(slots.data(), live);
+    std::shuffle(slots.begin(), slots.end(), rng);
+    for (void* p : slots) pool.deallocate(p);   // scrambled free list
+
+    std::vector<void*> held(64);
+    bench::Timer t;
+    for (std::size_t i = 0; i < ops; i += held.size()) {
+        for (auto& p : held) { p = pool.allocate(); static_cast<Obj*>(p)->key = i; }
+        for (void* p : held) pool.deallocate(p);
+        // rotate the list so the next batch walks cold nodes
+        void* cold[256];
+        pool.allocate_bulk(cold, 256);
+        pool.deallocate_bulk(cold, 256);
+    }
+    std::printf("churn    %-12s %5.2f ns/op\n", name, t.elapsed_ns() / double(ops));
+}
+
+int main() {
+    for (std::size_t n : {1000u, 100000u}) {
+        first_allocations("default", POOL_DEFAULT, n, false);
+        first_allocations("prefault", POOL_PREFAULT, n, false);
+        first_allocations("prefault+reserve", POOL_PREFAULT, n, true);
+    }
+    // Without reserve(), POOL_PREFAULT trades many small first-touch faults
+    // for one MAP_POPULATE stall of the whole chunk inside allocate(): lower
+    // p50/p99 but a max in the milliseconds. Reserve ahead to keep both low.
+    std::printf("note     prefault alone raises max latency to one full-chunk populate;"
+                " reserve() moves it off the hot path\n");
+
+    locality(1 << 20);
+
+    churn("default", POOL_DEFAULT, 1 << 20, 1 << 22);
+    churn("prefetch", POOL_PREFETCH, 1 << 20, 1 << 22);
+}
@@ -0,0 +1,179 @@
+//
+// Remote-free benchmark
+// Messages are allocated by one thread and freed by another.
+// 1) 1 producer x N consumers
+// 2) N x N message passing (every thread allocates and frees)
+// Owner pools with remote-free lists vs one mutex-protected pool.
+//
+
+#include "alloc/memory_pool.hpp"
+#include "alloc/cache_slab_allocator.hpp"
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static constexpr std::size_t MESSAGE_SIZE = 128;
+static constexpr std::size_t RING = 1024;
+
+// Single-producer single-consumer pointer ring
+class Ring {
+public:
+    bool push(void* p) {
+        std::size_t h = head_.load(std::memory_order_relaxed);
+        if (h - tail_.load(std::memory_order_acquire) == RING) return false;
+        slots_[h % RING] = p;
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    void* pop() {
+        std::size_t t = tail_.load(std::memory_order_relaxed);
+        if (t == head_.load(std::memory_order_acquire)) return nullptr;
+        void* p = slots_[t % RING];
+        tail_.store(t + 1, std::memory_order_release);
+        return p;
+    }
+
+private:
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    void* slots_[RING];
+};
+
+// Allocator front-ends used by the workloads
+struct OwnerPool {
+    MemoryPool pool{MESSAGE_SIZE, 4096};
+    void* allocate() { return pool.allocate(); }
+    void release(void* p) { pool.deallocate_remote(p); }
+};
+
+struct OwnerSlabCache {
+    SlabCache cache{MESSAGE_SIZE, 1 << 16};
+    void* allocate() { return cache.allocate(); }
+    void release(void* p) { cache.deallocate_remote(p); }
+};
+
+struct MutexPool {
+    std::mutex m;
+    MemoryPool pool{MESSAGE_SIZE, 4096};
+    void* allocate() { std::lock_guard<std::mutex> g(m); return pool.allocate(); }
+    void release(void* p) { std::lock_guard<std::mutex> g(m); pool.deallocate(p); }
+};
+
+static void touch(void* p, std::size_t v) { static_cast<std::size_t*>(p)[0] = v; }
+
+template <class Alloc>
+static double one_to_many(unsigned consumers, std::size_t messages) {
+    Alloc alloc;
+    std::vector<std::unique_ptr<Ring>> rings;
+    for (unsigned i = 0; i < consumers; ++i) rings.emplace_back(new Ring);
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    bench::Timer t;
+
+    for (unsigned c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            for (;;) {
+                void* p = rings[c]->pop();
+                if (p) { bench::do_not_optimize(*static_cast<std::size_t*>(p)); alloc.release(p); continue; }
+                if (done.load(std::memory_order_acquire) && !(p = rings[c]->pop())) break;
+                if (p) alloc.release(p);
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    for (std::size_t i = 0; i < messages; ++i) {
+        void* p = alloc.allocate();
+        touch(p, i);
+        while (!rings[i % consumers]->push(p)) std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& th : threads) th.join();
+
+    return double(messages) / (t.elapsed_ns() / 1e3);
+}
+
+// Every thread owns an allocator (or shares the mutex one) and sends
+// to every other thread round robin; receivers free what they get
+// back to the sender's allocator (its index is stamped in the message).
+template <class Alloc, bool Shared>
+static double many_to_many(unsigned n, std::size_t per_thread) {
+    std::vector<std::unique_ptr<Alloc>> allocs;
+    for (unsigned i = 0; i < (Shared ? 1u : n); ++i) allocs.emplace_back(new Alloc);
+
+    // rings[src * n + dst]
+    std::vector<std::unique_ptr<Ring>> rings;
+    for (unsigned i = 0; i < n * n; ++i) rings.emplace_back(new Ring);
+
+    const std::size_t total = per_thread * n;
+    std::atomic<std::size_t> received{0};
+    std::vector<std::thread> threads;
+    bench::Timer t;
+
+    for (unsigned self = 0; self < n; ++self) {
+        threads.emplace_back([&, self] {
+            Alloc& mine = *allocs[Shared ? 0 : self];
+            std::size_t sent = 0;
+            void* pending = nullptr;
+            unsigned dst = (self + 1) % n;
+
+            while (received.load(std::memory_order_relaxed) < total) {
+                bool progress = false;
+                if (sent < per_thread) {
+                    if (!pending) {
+                        pending = mine.allocate();
+                        touch(pending, self);
+                    }
+                    if (rings[self * n + dst]->push(pending)) {
+                        pending = nullptr;
+                        progress = true;
+                        ++sent;
+                        do { dst = (dst + 1) % n; } while (dst == self);
+                    }
+                }
+
+                std::size_t got = 0;
+                for (unsigned src = 0; src < n; ++src) {
+                    while (void* p = rings[src * n + self]->pop()) {
+                        std::size_t owner = *static_cast<std::size_t*>(p);
+                        allocs[Shared ? 0 : owner]->release(p);
+                        ++got;
+                    }
+                }
+
+                if (got) received.fetch_add(got, std::memory_order_relaxed);
+                else if (!progress) std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    return double(total) / (t.elapsed_ns() / 1e3);
+}
+
+int main() {
+    unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    const std::size_t messages = 1 << 20;
+
+    for (unsigned c = 1; c <= max_threads; c *= 2) {
+        std::printf("1x%-2u  remote-pool=%6.2f  remote-slabcache=%6.2f  mutex-pool=%6.2f  Mmsg/s\n", c,
+                    one_to_many<OwnerPool>(c, messages),
+                    one_to_many<OwnerSlabCache>(c, messages),
+                    one_to_many<MutexPool>(c, messages));
+    }
+
+    for (unsigned n = 2; n <= max_threads; n *= 2) {
+        std::printf("%ux%-2u  remote-pool=%6.2f  remote-slabcache=%6.2f  mutex-pool=%6.2f  Mmsg/s\n", n, n,
+                    many_to_many<OwnerPool, false>(n, messages / n),
+                    many_to_many<OwnerSlabCache, false>(n, messages / n),
+                    many_to_many<MutexPool, true>(n, messages / n));
+    }
+}
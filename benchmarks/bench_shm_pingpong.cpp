@@ -0,0 +1,188 @@
+//
+// Shared-memory pool ping-pong benchmark (two processes)
+// 1) shm pool : parent allocates a 64-byte message in a SharedMemoryPool,
+//               hands its offset to the child through a shared SPSC ring,
+//               the child adopts it, bumps the sequence and hands it back
+// 2) socket   : the same message serialized over an AF_UNIX socketpair
+// Reports round-trip latency percentiles. Finally a child allocates
+// and exits without freeing; recover() reclaims its blocks.
+//
+// On a single CPU every round trip includes two context switches.
+//
+
+#include "alloc/shared_memory_pool.hpp"
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static constexpr std::size_t ROUNDS = 100'000;
+static constexpr std::size_t RING = 1024;
+static constexpr std::uint64_t STOP = ~0ull;
+
+struct Msg {
+    std::uint64_t seq;
+    char payload[56];
+};
+
+// Single-producer / single-consumer ring of offsets in a shared mapping
+struct Ring {
+    alignas(64) std::atomic<std::uint64_t> head{0};
+    alignas(64) std::atomic<std::uint64_t> tail{0};
+    std::uint64_t slots[RING];
+
+    void push(std::uint64_t v) {
+        std::uint64_t t = tail.load(std::memory_order_relaxed);
+        while (t - head.load(std::memory_order_acquire) == RING) std::this_thread::yield();
+        slots[t % RING] = v;
+        tail.store(t + 1, std::memory_order_release);
+    }
+
+    std::uint64_t pop() {
+        std::uint64_t h = head.load(std::memory_order_relaxed);
+        for (unsigned spins = 0; tail.load(std::memory_order_acquire) == h; ++spins)
+            if (spins > 64) std::this_thread::yield();
+        std::uint64_t v = slots[h % RING];
+        head.store(h + 1, std::memory_order_release);
+        return v;
+    }
+};
+
+struct Channel {
+    Ring to_child;
+    Ring to_parent;
+};
+
+static void report(const char* name, std::vector<double>& rtt) {
+    std::sort(rtt.begin(), rtt.end());
+    auto pct = [&](double p) { return rtt[static_cast<std::size_t>(p * (rtt.size() - 1))]; };
+    std::printf("%-10s rtt p50=%8.0f ns  p99=%8.0f ns  p99.9=%8.0f ns\n",
+                name, pct(0.50), pct(0.99), pct(0.999));
+}
+
+static void shm_pingpong(const char* name) {
+    SharedMemoryPool pool(name, SharedMemoryPool::Mode::Create, sizeof(Msg), 4096,
+                          SlotLayout::CacheAligned);
+
+    void* map = mmap(nullptr, sizeof(Channel), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    Channel* ch = new (map) Channel();
+
+    pid_t child = fork();
+    if (child == 0) {
+        // A separate process attaches by name, as an unrelated one would
+        SharedMemoryPool peer(name, SharedMemoryPool::Mode::Open);
+        for (;;) {
+            std::uint64_t off = ch->to_child.pop();
+            if (off == STOP) break;
+            Msg* m = static_cast<Msg*>(peer.at(off));
+            peer.adopt(m);
+            m->seq += 1;
+            ch->to_parent.push(off);
+        }
+        _exit(0);
+    }
+
+    std::vector<double> rtt(ROUNDS);
+    for (std::size_t i = 0; i < ROUNDS; ++i) {
+        bench::Timer timer;
+        Msg* m = static_cast<Msg*>(pool.allocate());
+        m->seq = i;
+        std::memset(m->payload, 'x', sizeof(m->payload));
+        ch->to_child.push(pool.offset_of(m));
+
+        Msg* back = static_cast<Msg*>(pool.at(ch->to_parent.pop()));
+        bench::do_not_optimize(back->seq);
+        pool.deallocate(back);
+        rtt[i] = timer.elapsed_ns();
+    }
+
+    ch->to_child.push(STOP);
+    waitpid(child, nullptr, 0);
+    munmap(map, sizeof(Channel));
+
+    report("shm pool", rtt);
+}
+
+static bool io_exact(int fd, void* buf, std::size_t n, bool write_side) {
+    char* p = static_cast<char*>(buf);
+    while (n) {
+        ssize_t r = write_side ? write(fd, p, n) : read(fd, p, n);
+        if (r <= 0) return false;
+        p += r;
+        n -= static_cast<std::size_t>(r);
+    }
+    return true;
+}
+
+static void socket_pingpong() {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return;
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(fds[0]);
+        Msg m;
+        while (io_exact(fds[1], &m, sizeof(m), false)) {
+            m.seq += 1;
+            io_exact(fds[1], &m, sizeof(m), true);
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+
+    std::vector<double> rtt(ROUNDS);
+    for (std::size_t i = 0; i < ROUNDS; ++i) {
+        bench::Timer timer;
+        Msg m;
+        m.seq = i;
+        std::memset(m.payload, 'x', sizeof(m.payload));
+        io_exact(fds[0], &m, sizeof(m), true);
+        io_exact(fds[0], &m, sizeof(m), false);
+        bench::do_not_optimize(m.seq);
+        rtt[i] = timer.elapsed_ns();
+    }
+
+    close(fds[0]);
+    waitpid(child, nullptr, 0);
+
+    report("socket", rtt);
+}
+
+static void crash_recovery(const char* name) {
+    SharedMemoryPool pool(name, SharedMemoryPool::Mode::Open);
+    std::size_t before = pool.free_blocks();
+
+    pid_t child = fork();
+    if (child == 0) {
+        SharedMemoryPool peer(name, SharedMemoryPool::Mode::Open);
+        for (int i = 0; i < 100; ++i) peer.allocate();
+        _exit(0);   // "crash" while holding 100 blocks
+    }
+    waitpid(child, nullptr, 0);
+
+    std::size_t leaked = before - pool.free_blocks();
+    std::size_t reclaimed = pool.recover();
+    std::printf("recovery   dead child held %zu blocks, recover() reclaimed %zu, free=%zu/%zu\n",
+                leaked, reclaimed, pool.free_blocks(), pool.block_count());
+}
+
+int main() {
+    std::string name = "/alloc_bench_pingpong_" + std::to_string(getpid());
+
+    shm_pingpong(name.c_str());
+    socket_pingpong();
+    crash_recovery(name.c_str());
+
+    SharedMemoryPool::unlink(name.c_str());
+}
@@ -0,0 +1,114 @@
+//
+// Zeroing benchmark
+// Arenas of 64 KiB .. 256 MiB are filled with 64-byte objects that
+// must start zeroed (one field is then written), reset, and filled
+// again, for about 1 GiB of objects per size.
+// 1) memset/object  : ZeroPolicy::None, caller memsets each object
+// 2) OnAllocate     : the arena zeroes each object as handed out
+// 3) OnReset        : reset() wipes the used region in one pass
+//                     (memset, or streaming stores above the threshold)
+// 4) ReleaseOnReset : reset() hands the pages back; the next fill
+//                     faults them in zeroed
+// Columns: fill = allocate + use, reset = reset(), in ns per object.
+// Also reports raw zero_memory against memset.
+//
+
+#include "alloc/arena_allocator.hpp"
+#include "alloc/os_memory.hpp"
+#include "alloc/zeroing.hpp"
+#include "bench_common.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+static constexpr std::size_t OBJECT = 64;
+static constexpr std::size_t TOTAL = std::size_t(1) << 30;
+static constexpr std::size_t MIN_ARENA = std::size_t(64) << 10;
+static constexpr std::size_t MAX_ARENA = std::size_t(256) << 20;
+
+struct alignas(OBJECT) Object {
+    std::uint64_t fields[OBJECT / sizeof(std::uint64_t)];
+};
+
+struct Cost {
+    double fill;
+    double reset;
+};
+
+template <bool ManualMemset>
+static Cost run(std::size_t arena_size, ZeroPolicy zero) {
+    ArenaAllocator arena(arena_size + OBJECT, zero);     // room to align the first object
+    std::size_t per_fill = arena_size / OBJECT;
+    std::size_t cycles = TOTAL / arena_size;
+    std::uint64_t sum = 0;
+    double fill_ns = 0, reset_ns = 0;
+
+    for (std::size_t c = 0; c < cycles; ++c) {
+        bench::Timer timer;
+        for (std::size_t i = 0; i < per_fill; ++i) {
+            auto* o = static_cast<Object*>(arena.allocate(sizeof(Object), alignof(Object)));
+            if constexpr (ManualMemset) std::memset(o, 0, sizeof(Object));
+            sum += o->fields[1];
+            o->fields[0] = i;
+        }
+        fill_ns += timer.elapsed_ns();
+
+        timer.reset();
+        arena.reset();
+        reset_ns += timer.elapsed_ns();
+    }
+
+    bench::do_not_optimize(sum);
+    double objects = static_cast<double>(cycles * per_fill);
+    return {fill_ns / objects, reset_ns / objects};
+}
+
+static void print(const char* name, Cost c) {
+    std::printf("  %-16s fill %6.2f  reset %6.2f  total %6.2f ns/object\n",
+                name, c.fill, c.reset, c.fill + c.reset);
+}
+
+static void raw_zeroing() {
+    std::printf("raw zeroing (GB/s)\n");
+    for (std::size_t size = MIN_ARENA; size <= MAX_ARENA; size <<= 2) {
+        auto* p = static_cast<std::byte*>(os_map(size, true));
+        if (!p) return;
+        std::size_t reps = TOTAL / size;
+
+        bench::Timer timer;
+        for (std::size_t r = 0; r < reps; ++r) {
+            std::memset(p, 0, size);
+            bench::do_not_optimize(p);
+        }
+        double plain = timer.elapsed_ns();
+
+        timer.reset();
+        for (std::size_t r = 0; r < reps; ++r) {
+            zero_memory(p, size);
+            bench::do_not_optimize(p);
+        }
+        double ours = timer.elapsed_ns();
+
+        double bytes = static_cast<double>(reps * size);
+        std::printf("  %7zu KiB  memset %6.1f  zero_memory %6.1f\n",
+                    size >> 10, bytes / plain, bytes / ours);
+        os_unmap(p, size);
+    }
+    std::printf("\n");
+}
+
+int main() {
+    std::printf("zero kernel: %s, streaming above %zu KiB\n\n",
+                zero_kernel_name(), zero_stream_threshold() >> 10);
+
+    raw_zeroing();
+
+    for (std::size_t size = MIN_ARENA; size <= MAX_ARENA; size <<= 2) {
+        std::printf("arena %zu KiB\n", size >> 10);
+        print("memset/object", run<true>(size, ZeroPolicy::None));
+        print("OnAllocate", run<false>(size, ZeroPolicy::OnAllocate));
+        print("OnReset", run<false>(size, ZeroPolicy::OnReset));
+        print("ReleaseOnReset", run<false>(size, ZeroPolicy::ReleaseOnReset));
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+//
+// cache-scratch (Hoard suite)
+// The main thread allocates one small object per worker and hands it
+// over; each worker frees it, then repeatedly allocates an object of
+// the same size, writes it many times and frees it. An allocator that
+// hands a worker memory sharing a cache line with another worker's
+// (passive false sharing) shows up as poor scaling.
+//
+// usage: stress_cache_scratch [threads] [iterations] [size] [writes]
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    unsigned threads = argc > 1 ? std::atoi(argv[1]) : 4;
+    std::size_t iterations = argc > 2 ? std::atoi(argv[2]) : 1000;
+    std::size_t size = argc > 3 ? std::atoi(argv[3]) : 8;
+    std::size_t writes = argc > 4 ? std::atoi(argv[4]) : 100000;
+
+    std::vector<char*> handed(threads);
+    for (auto& p : handed) p = static_cast<char*>(std::malloc(size));
+
+    auto worker = [&](unsigned id) {
+        std::free(handed[id]);
+        for (std::size_t i = 0; i < iterations; ++i) {
+            volatile char* p = static_cast<char*>(std::malloc(size));
+            for (std::size_t w = 0; w < writes / iterations; ++w)
+                for (std::size_t b = 0; b < size; ++b) p[b] = p[b] + 1;
+            std::free(const_cast<char*>(p));
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker, t);
+    for (auto& t : pool) t.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("cache-scratch threads=%u  %.3f s\n", threads, elapsed);
+}
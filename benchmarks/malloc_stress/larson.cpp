@@ -0,0 +1,74 @@
+//
+// Larson-like server workload
+// Each thread owns an array of live objects and keeps replacing a
+// random one (free + malloc of a random size). After every round
+// the arrays rotate to the next thread, so most frees happen on a
+// thread other than the allocating one.
+//
+// usage: stress_larson [threads] [seconds] [objects] [min] [max]
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    unsigned threads = argc > 1 ? std::atoi(argv[1]) : 4;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 3.0;
+    std::size_t objects = argc > 3 ? std::atoi(argv[3]) : 1000;
+    std::size_t min_size = argc > 4 ? std::atoi(argv[4]) : 10;
+    std::size_t max_size = argc > 5 ? std::atoi(argv[5]) : 500;
+
+    std::vector<std::vector<char*>> arrays(threads, std::vector<char*>(objects));
+    std::vector<std::mutex> owners(threads);
+    for (auto& a : arrays)
+        for (auto& p : a) p = static_cast<char*>(std::malloc(min_size));
+
+    std::atomic<bool> stop{false};
+    std::atomic<unsigned long long> total{0};
+    const std::size_t ROUND = 10000;
+
+    auto worker = [&](unsigned id) {
+        std::mt19937 rng(id + 1);
+        std::uniform_int_distribution<std::size_t> size(min_size, max_size);
+        std::uniform_int_distribution<std::size_t> slot(0, objects - 1);
+
+        unsigned long long ops = 0;
+        for (unsigned round = 0; !stop.load(std::memory_order_relaxed); ++round) {
+            // Take over whichever array is free, starting from another
+            // thread's one from the previous round
+            unsigned k0 = (id + round) % threads;
+            while (!owners[k0].try_lock()) k0 = (k0 + 1) % threads;
+            std::vector<char*>& a = arrays[k0];
+            for (std::size_t i = 0; i < ROUND; ++i) {
+                std::size_t j = slot(rng);
+                std::free(a[j]);
+                std::size_t n = size(rng);
+                a[j] = static_cast<char*>(std::malloc(n));
+                a[j][0] = a[j][n - 1] = 1;
+            }
+            owners[k0].unlock();
+            ops += ROUND;
+        }
+        total += ops;
+    };
+
+    std::vector<std::thread> pool;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker, t);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& th : pool) th.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto& a : arrays)
+        for (char* p : a) std::free(p);
+
+    std::printf("larson       threads=%u  %.2f Mops/s\n", threads, total / elapsed / 1e6);
+}
@@ -0,0 +1,26 @@
+#!/bin/sh
+#
+# Run the malloc stress workloads against glibc and against
+# liballocators_malloc.so (LD_PRELOAD).
+#
+# usage: benchmarks/malloc_stress/run.sh [build-dir] [threads]
+#
+
+BUILD=${1:-build}
+THREADS=${2:-$(nproc)}
+SHIM="$BUILD/liballocators_malloc.so"
+
+if [ ! -f "$SHIM" ]; then
+    echo "missing $SHIM (configure with -DALLOC_BUILD_MALLOC_SHIM=ON and build)" >&2
+    exit 1
+fi
+
+run() {
+    echo "== $*"
+    printf 'glibc : '; "$@"
+    printf 'shim  : '; LD_PRELOAD="$SHIM" "$@"
+}
+
+run "$BUILD/stress_larson" "$THREADS" 3 1000 10 500
+run "$BUILD/stress_xmalloc" "$(( (THREADS + 1) / 2 ))" 3 256
+run "$BUILD/stress_cache_scratch" "$THREADS" 1000 8 1000000
@@ -0,0 +1,99 @@
+//
+// xmalloc-like producer/consumer workload
+// Producer threads allocate batches of random-size objects and hand
+// them to consumer threads, which free them: every free is remote.
+//
+// usage: stress_xmalloc [pairs] [seconds] [max_size]
+//
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct Queue {
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<std::vector<void*>> batches;
+    bool closed = false;
+};
+
+int main(int argc, char** argv) {
+    unsigned pairs = argc > 1 ? std::atoi(argv[1]) : 2;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 3.0;
+    std::size_t max_size = argc > 3 ? std::atoi(argv[3]) : 256;
+
+    const std::size_t BATCH = 256;
+    const std::size_t MAX_QUEUED = 64;
+
+    std::vector<Queue> queues(pairs);
+    std::atomic<bool> stop{false};
+    std::atomic<unsigned long long> freed{0};
+
+    auto producer = [&](unsigned id) {
+        std::mt19937 rng(id + 7);
+        std::uniform_int_distribution<std::size_t> size(8, max_size);
+        Queue& q = queues[id];
+
+        while (!stop.load(std::memory_order_relaxed)) {
+            std::vector<void*> batch(BATCH);
+            for (void*& p : batch) {
+                std::size_t n = size(rng);
+                p = std::malloc(n);
+                static_cast<char*>(p)[n - 1] = 1;
+            }
+
+            std::unique_lock<std::mutex> g(q.lock);
+            q.ready.wait(g, [&] { return q.batches.size() < MAX_QUEUED || stop.load(); });
+            q.batches.push_back(std::move(batch));
+            q.ready.notify_all();
+        }
+
+        std::lock_guard<std::mutex> g(q.lock);
+        q.closed = true;
+        q.ready.notify_all();
+    };
+
+    auto consumer = [&](unsigned id) {
+        Queue& q = queues[id];
+        unsigned long long n = 0;
+
+        for (;;) {
+            std::vector<void*> batch;
+            {
+                std::unique_lock<std::mutex> g(q.lock);
+                q.ready.wait(g, [&] { return !q.batches.empty() || q.closed; });
+                if (q.batches.empty()) break;
+                batch = std::move(q.batches.front());
+                q.batches.pop_front();
+                q.ready.notify_all();
+            }
+            for (void* p : batch) std::free(p);
+            n += batch.size();
+        }
+        freed += n;
+    };
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < pairs; ++i) {
+        threads.emplace_back(producer, i);
+        threads.emplace_back(consumer, i);
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (Queue& q : queues) {
+        std::lock_guard<std::mutex> g(q.lock);
+        q.ready.notify_all();
+    }
+    for (auto& t : threads) t.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("xmalloc      pairs=%u  %.2f Mfrees/s\n", pairs, freed / elapsed / 1e6);
+}
@@ -0,0 +1,41 @@
+#include "alloc/coro_task.hpp"
+#include <iostream>
+
+Task<int> square(int x)
+{
+    co_return x * x;
+}
+
+// Frames of this call tree nest strictly: a stack resource fits
+Task<int> sum_of_squares(int n)
+{
+    int sum = 0;
+    for (int i = 1; i <= n; ++i)
+        sum += co_await square(i);
+    co_return sum;
+}
+
+// Explicit resource: std::allocator_arg + resource as the first parameters
+Task<int> tagged(std::allocator_arg_t, FrameResource&, int x)
+{
+    co_return x + 1000;
+}
+
+int main()
+{
+    PoolFrameResource pool;
+    StackFrameResource stack(16 << 10);
+
+    {
+        FrameResourceScope scope(pool);
+        std::cout << "pool:  sum_of_squares(10) = " << sum_of_squares(10).get() << "\n";
+    }
+
+    {
+        FrameResourceScope scope(stack);
+        std::cout << "stack: sum_of_squares(10) = " << sum_of_squares(10).get() << "\n";
+        std::cout << "stack bytes free after the tree finished: " << stack.remaining() << "\n";
+    }
+
+    std::cout << "explicit pool: " << tagged(std::allocator_arg, pool, 1).get() << "\n";
+}
@@ -0,0 +1,48 @@
+#include "alloc/persistent_arena.hpp"
+#include "alloc/offset_containers.hpp"
+#include <cstdio>
+#include <iostream>
+
+// Everything reachable from the root lives in the file and links by offset
+struct Catalog {
+    offset_vector<offset_string> names;
+    offset_hash_map<offset_string, std::uint32_t> index;
+};
+
+int main()
+{
+    const char* path = "example_catalog.arena";
+
+    // Build once and flush to disk
+    {
+        PersistentArena arena(path, PersistentArena::Mode::Create, 1 << 20);
+        Catalog* catalog = arena.construct<Catalog>();
+
+        for (const char* name : {"alpha", "beta", "gamma", "delta"}) {
+            offset_string& s = catalog->names.emplace_back(arena, arena, name);
+            catalog->index.insert(arena, s, static_cast<std::uint32_t>(catalog->names.size() - 1));
+        }
+
+        arena.set_root(catalog);
+        arena.sync();
+
+        std::cout << "Built catalog: " << arena.used() << " of "
+                  << arena.capacity() << " bytes used\n";
+    }
+
+    // A later run maps the file and uses it in place
+    {
+        PersistentArena arena(path, PersistentArena::Mode::ReadOnly);
+        const Catalog* catalog = arena.root_as<Catalog>();
+
+        std::cout << "Loaded " << catalog->names.size() << " names:";
+        for (const offset_string& s : catalog->names)
+            std::cout << ' ' << s.c_str();
+        std::cout << "\n";
+
+        if (const std::uint32_t* id = catalog->index.find("gamma"))
+            std::cout << "gamma -> " << *id << "\n";
+    }
+
+    std::remove(path);
+}
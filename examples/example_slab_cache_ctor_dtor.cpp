@@ -1,5 +1,7 @@
 #include "alloc/cache_slab_allocator.hpp"
+#include "alloc/typed_slab_cache.hpp"
 #include <iostream>
+#include <string>
 
 struct User
 {
@@ -7,13 +9,13 @@ struct User
     std::string name;
 };
 
-// Constructor callback
+// Constructor callback: runs once per slot when its slab is created
 void user_ctor(void* p)
 {
     new (p) User{0, ""}; // placement new
 }
 
-// Destructor callback
+// Destructor callback: runs once per slot when its slab is destroyed
 void user_dtor(void* p)
 {
     static_cast<User*>(p)->~User();
@@ -29,7 +31,19 @@ int main()
 
     std::cout << "User: " << u1->id << ", " << u1->name << "\n";
 
+    // The object stays constructed while it sits in the cache
     cache.deallocate(u1);
 
+    // Typed front-end: T() runs once per slot, not once per allocate
+    TypedSlabCache<User> users;
+
+    User* u2 = users.allocate();
+    u2->id = 7;
+    u2->name = "Trinity";
+
+    std::cout << "User: " << u2->id << ", " << u2->name << "\n";
+
+    users.deallocate(u2);
+
     return 0;
 }
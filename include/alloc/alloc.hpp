@@ -4,4 +4,15 @@
 #include "alloc/slab_allocator.hpp"
 #include "alloc/arena_allocator.hpp"
 #include "alloc/monotonic_allocator.hpp"
-#include "alloc/stack_allocator.hpp"
\ No newline at end of file
+#include "alloc/stack_allocator.hpp"
+#include "alloc/cache_slab_allocator.hpp"
+#include "alloc/typed_slab_cache.hpp"
+#include "alloc/percpu_slab_cache.hpp"
+#include "alloc/slot_layout.hpp"
+#include "alloc/trim_policy.hpp"
+#include "alloc/persistent_arena.hpp"
+#include "alloc/offset_ptr.hpp"
+#include "alloc/offset_containers.hpp"
+#include "alloc/shared_memory_pool.hpp"
+#include "alloc/generational_arena.hpp"
+#include "alloc/zeroing.hpp"
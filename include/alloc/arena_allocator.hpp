@@ -7,13 +7,19 @@
 // - O(1) allocation: pointer increment
 // - No per-object free; memory reclaimed via reset()
 // - Zero fragmentation, strong locality
+// - ALLOC_GUARD_PAGES builds map the region between guard pages
+// - Optional ZeroPolicy (see zeroing.hpp): OnReset keeps the free
+//   region zeroed (fresh zero pages at start, used region wiped on
+//   reset), OnAllocate zeroes each block as it is handed out
 //
 
 #include <cstddef>
+#include <cstdint>
 #include <cassert>
 #include <new>
 #include <memory>
 #include <algorithm>
+#include "alloc/zeroing.hpp"
 
 class ArenaAllocator
 {
@@ -22,6 +28,7 @@ private:
     std::byte* start_;      // Start of the memory block
     std::byte* current_;    // Bump pointer (next allocation point)
     std::byte* end_;        // End of the memory block (start_ + size_)
+    ZeroPolicy zero_;       // When handed-out memory is zeroed
 
     // Align pointer forward to the required boundary
     static std::byte* align_ptr(std::byte* ptr, std::size_t alignment) noexcept;
@@ -29,12 +36,13 @@ private:
 public:
     // Allocate a contiguous block of memory of given size
     // Alignment defaults to max_align_t for general-purpose use
-    explicit ArenaAllocator(std::size_t size);
+    explicit ArenaAllocator(std::size_t size, ZeroPolicy zero = ZeroPolicy::None);
 
     // Fast O(1) bump allocation; returns nullptr if arena is full
     void* allocate(std::size_t n, std::size_t alignment = alignof(std::max_align_t));
 
     // Reset arena: all allocations become invalid, bump pointer returns to start
+    // Under OnReset / ReleaseOnReset the used region is zeroed here
     void reset() noexcept;
 
     // Remaining free bytes in the arena
@@ -43,6 +51,8 @@ public:
     // Total capacity of the arena
     std::size_t size() const noexcept;
 
+    ZeroPolicy zero_policy() const noexcept { return zero_; }
+
     // Release the backing memory
     ~ArenaAllocator();
 };
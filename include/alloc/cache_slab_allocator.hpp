@@ -6,7 +6,19 @@
    - One cache per object type
    - Manages slabs: Empty / Partial / Full
    - Bitmap-based tracking inside each slab
-   - Optional constructor / destructor per object
+   - Object caching (Bonwick): the optional constructor runs
+     once per slot when its slab is created, the destructor
+     only when the slab is destroyed. Freed objects keep their
+     constructed state and must be returned in it.
+   - Optional cache-line slot layout and slab colouring
+   - Optional object alignment up to MAX_SLOT_ALIGNMENT
+     (slots rounded to it, slabs aligned to it)
+   - Hardened builds (see hardening.hpp) detect double
+     frees via the bitmap and double remote frees via a
+     tag next to the link; ASan builds poison free slots
+   - Owned by one thread; other threads free through a
+     lock-free remote-free list the owner drains in batches
+     (caches with a ctor opt in, see remote_frees)
    - All operations are fixed-size and predictable
 -------------------------------------------*/
 
@@ -15,8 +27,12 @@
 #include <cassert>
 #include <vector>
 #include <list>
+#include <map>
 #include <cstdlib>
 #include <algorithm>
+#include <atomic>
+#include "alloc/hardening.hpp"
+#include "alloc/slot_layout.hpp"
 
 /* -----------------------------------------------------------
    SLAB STRUCT
@@ -26,11 +42,17 @@
 
 struct Slab {
     std::byte* memory;                  // start of slab memory
+    std::byte* objects;                 // first object slot (memory + colour)
     std::vector<uint8_t> bitmap;        // 1 = map, 0 = used
     size_t free_count;                   // how many object slots free
-
-    Slab(std::byte* mem, size_t objectCount) 
-        : memory(mem), bitmap(objectCount, 1),
+    size_t first_free = 0;              // no free slot below this index
+    size_t batch_free = 0;              // free_count before the current bulk free
+    bool in_batch = false;              // touched by the current bulk free
+    std::list<Slab*>* list = nullptr;   // state list holding this slab
+    std::list<Slab*>::iterator node;    // this slab's entry in it
+
+    Slab(std::byte* mem, std::byte* first, size_t objectCount) 
+        : memory(mem), objects(first), bitmap(objectCount, 1),
           free_count(objectCount) 
     {}
 };
@@ -49,27 +71,101 @@ class SlabCache {
         Constructor: Create a slab cache
         object_size : size of each object
         slab_size   : size of each slab (default 4096)
-        ctor        : optional constructor per object
-        dtor        : optional destructor per object
+        ctor        : optional constructor, run once per slot
+                      when its slab is created
+        dtor        : optional destructor, run once per slot
+                      when its slab is destroyed (needs ctor)
+        layout      : slot packing (see SlotLayout)
+        colouring   : offset the first object of successive
+                      slabs by one cache line (Linux SLAB colour),
+                      or by one alignment unit if that is larger
+        alignment   : power of two every object is aligned to
+                      (1 keeps the packed stride's natural one)
+        remote_frees: allow deallocate_remote on a cache whose
+                      free slots cannot carry the list link
+                      (with a ctor, or objects smaller than a
+                      pointer). Costs a link word per slot;
+                      other caches always allow remote frees
         -------------------------------------------*/
         SlabCache(size_t object_size,
                 size_t slab_size = 4096,
                 Ctor ctor = nullptr,
-                Dtor dtor = nullptr);
+                Dtor dtor = nullptr,
+                SlotLayout layout = SlotLayout::Packed,
+                bool colouring = false,
+                size_t alignment = 1,
+                bool remote_frees = false);
         
-        // Returns pointer to one free object slot
+        // Returns pointer to one free (already constructed) object
         void* allocate();
 
-        // Returns an object back to its slab
+        // Returns an object back to its slab; it stays constructed
         void deallocate(void* ptr);
 
+        /* ------------------------------------------
+        deallocate_remote
+        - Safe from any thread, lock-free (MPSC push)
+        - The owner takes the objects back in a batch
+          when it runs out of free slots, or on trim()
+        - Caches with a ctor need remote_frees
+        -------------------------------------------*/
+        void deallocate_remote(void* ptr) noexcept;
+
+        /* ------------------------------------------
+        Bulk variants
+        - allocate_bulk drains whole slabs at a time,
+          one state transition per slab
+        - deallocate_bulk reclassifies each touched
+          slab once at the end of the batch
+        -------------------------------------------*/
+        std::size_t allocate_bulk(void** out, std::size_t n);
+        void deallocate_bulk(void** in, std::size_t n);
+
+        /* ------------------------------------------
+        Reclaim
+        - slab_bytes : bytes of slab memory held
+        - free_bytes : bytes in free slots of all slabs
+        - trim       : destroys empty slabs until at most
+                       max_retained_bytes stay free
+        - shrink     : destroys every empty slab
+        -------------------------------------------*/
+        std::size_t slab_bytes() const noexcept;
+        std::size_t free_bytes() const noexcept;
+        std::size_t trim(std::size_t max_retained_bytes);
+        std::size_t shrink() { return trim(0); }
+
+        // Distance between consecutive object slots
+        std::size_t slot_size() const noexcept { return slot_size_; }
+
+        // Number of distinct colours successive slabs cycle through
+        std::size_t colours() const noexcept { return colours_; }
+
         // frees all slabs and memory
         ~SlabCache();
     
     private:
+        // Remote-free link threaded through a slot; copied with memcpy,
+        // since a trailing link may sit at any offset
+        struct RemoteLink {
+            void* next;
+#if ALLOC_HARDENING
+            std::uintptr_t key;         // tag while queued remotely
+#endif
+        };
+
         std::size_t object_size_;       // Size of each object
         std::size_t slab_size_;         // Size of each slab (bytes)
         std::size_t objects_per_slab_;  // How many objects fit in the slab
+        std::size_t slot_size_;         // Object stride after layout rounding
+        std::size_t slab_alignment_;    // Alignment of slab memory
+        std::size_t colour_step_;       // Offset between colours
+
+        std::size_t colours_ = 1;       // Number of colour offsets available
+        std::size_t colour_next_ = 0;   // Colour for the next slab created
+
+        std::size_t link_offset_;       // Remote-free link position in a slot
+        bool remote_frees_;             // Slots can carry the remote-free link
+        std::atomic<void*> remote_free_{nullptr}; // Objects freed by other threads
 
         Ctor ctor_;                     // Optional per-object constructor
         Dtor dtor_;                     // Optional per-object destructor
@@ -77,6 +173,7 @@ class SlabCache {
         std::list<Slab*> empty_slabs_;  // Slabs with all slots free
         std::list<Slab*> partial_slabs_; // Slabs with some free slots
         std::list<Slab*> full_slabs_;   // Slabs with no free slots
+        std::map<std::byte*, Slab*> slab_index_; // Every slab, by memory address
         
         /* ------------------------------------------
         create_slab
@@ -87,10 +184,11 @@ class SlabCache {
 
         /* ------------------------------------------
         destroy_slab
-        - Runs destructors
+        - Runs destructors on every slot
+        - Optionally discards the pages (trim path)
         - Frees memory
         -------------------------------------------*/
-        void destroy_slab(Slab* slab);
+        void destroy_slab(Slab* slab, bool discard = false);
 
         /* ------------------------------------------
         allocate_from_slab
@@ -98,16 +196,50 @@ class SlabCache {
         -------------------------------------------*/
         void* allocate_from_slab(Slab* slab);
 
+        /* ------------------------------------------
+        drain_remote
+        - Owner side: takes the whole remote-free list
+          and returns it through deallocate_bulk
+        - Returns the number of objects reclaimed
+        -------------------------------------------*/
+        std::size_t drain_remote();
+
+        /* ------------------------------------------
+        allocate_many_from_slab
+        - Claims up to n free slots in one bitmap pass
+        -------------------------------------------*/
+        std::size_t allocate_many_from_slab(Slab* slab, void** out, std::size_t n);
+
+        /* ------------------------------------------
+        release_slot
+        - Marks the slot holding p free in the bitmap
+        - Hardened builds abort on double free or a
+          pointer that is not a slot boundary
+        -------------------------------------------*/
+        std::size_t release_slot(Slab* slab, std::byte* p);
+
+        /* ------------------------------------------
+        reclassify_batch
+        - Moves each slab touched by a bulk free to
+          the list its new free count calls for
+        - Clears the slabs' batch marks
+        -------------------------------------------*/
+        void reclassify_batch(Slab** touched, std::size_t n);
+
         /* ------------------------------------------
         find_slab_containing
         - Find which slab a pointer belongs to
+        - O(log slabs) through slab_index_
         -------------------------------------------*/
         Slab* find_slab_containing(void* ptr);
 
         /* ------------------------------------------
-        move_to_empty / move_to_partial
+        move_to_empty / move_to_partial / move_to_full
         - Handle slab state transitions
+        - O(1): the slab's list node is spliced over
         -------------------------------------------*/
-        void move_to_empty(Slab* slab);
-        void move_to_partial(Slab* slab);
+        void move_to(Slab* slab, std::list<Slab*>& to);
+        void move_to_empty(Slab* slab) { move_to(slab, empty_slabs_); }
+        void move_to_partial(Slab* slab) { move_to(slab, partial_slabs_); }
+        void move_to_full(Slab* slab) { move_to(slab, full_slabs_); }
 };
\ No newline at end of file
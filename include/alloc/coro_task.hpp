@@ -0,0 +1,193 @@
+#pragma once
+
+/* ------------------------------------------
+   Coroutine frame allocation (C++20)
+   - FrameAllocatedPromise: mixin for a promise_type that draws
+     frames from a FrameResource instead of global new
+       * default: the thread's current resource
+         (FrameResourceScope, see frame_resource.hpp)
+       * explicit: std::allocator_arg, FrameResource& as the first
+         coroutine parameters (after the object for members)
+   - The resource is remembered in a 16-byte header in front of
+     the frame, so the frame is freed where it came from even if
+     the current resource changed meanwhile
+   - A resource that is full (StackFrameResource) falls back to
+     the heap for that frame
+   - Task<T, Alloc>: lazily started, awaitable task using symmetric
+     transfer; Alloc is the promise's allocation mixin
+     (DefaultFrameAllocation keeps plain operator new)
+-------------------------------------------*/
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+#include "alloc/frame_resource.hpp"
+
+// The explicit-resource operator new overloads are templates, and the
+// coroutine frees their frames through the usual sized delete below,
+// a pairing the standard prescribes. GCC's -Wmismatched-new-delete
+// (-Wall) cannot match a template operator new with a non-template
+// delete and flags every such coroutine at -O0. Always inlining the
+// templates leaves allocate_frame as the visible allocation, which
+// the check does not track.
+#if defined(__GNUC__)
+#define ALLOC_CORO_ALWAYS_INLINE __attribute__((always_inline))
+#else
+#define ALLOC_CORO_ALWAYS_INLINE
+#endif
+
+struct FrameAllocatedPromise {
+    static void* operator new(std::size_t n) {
+        return allocate_frame(*current_frame_resource(), n);
+    }
+
+    template <class... Args>
+    ALLOC_CORO_ALWAYS_INLINE
+    static void* operator new(std::size_t n, std::allocator_arg_t, FrameResource& r, Args&&...) {
+        return allocate_frame(r, n);
+    }
+
+    // Member coroutines: the object comes first
+    template <class Obj, class... Args>
+    ALLOC_CORO_ALWAYS_INLINE
+    static void* operator new(std::size_t n, Obj&, std::allocator_arg_t, FrameResource& r, Args&&...) {
+        return allocate_frame(r, n);
+    }
+
+    static void operator delete(void* frame, std::size_t n) noexcept {
+        std::byte* base = static_cast<std::byte*>(frame) - HEADER;
+        FrameResource* owner = *reinterpret_cast<FrameResource**>(base);
+        owner->deallocate(base, n + HEADER);
+    }
+
+private:
+    // Keeps the frame at operator new's default alignment
+    static constexpr std::size_t HEADER = alignof(std::max_align_t);
+
+    static void* allocate_frame(FrameResource& r, std::size_t n) {
+        FrameResource* owner = &r;
+        void* p = r.allocate(n + HEADER);
+        if (!p) {
+            owner = &heap_frame_resource();
+            p = owner->allocate(n + HEADER);
+        }
+
+        *static_cast<FrameResource**>(p) = owner;
+        return static_cast<std::byte*>(p) + HEADER;
+    }
+};
+
+// Allocation mixin that changes nothing: frames use global new
+struct DefaultFrameAllocation {};
+
+namespace coro_detail {
+
+template <class T>
+struct TaskResult {
+    std::optional<T> value;
+    std::exception_ptr error;
+
+    void return_value(T v) { value.emplace(std::move(v)); }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+
+    T take() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct TaskResult<void> {
+    std::exception_ptr error;
+
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+
+    void take() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+} // namespace coro_detail
+
+template <class T = void, class Alloc = FrameAllocatedPromise>
+class Task {
+    public:
+        struct promise_type : Alloc, coro_detail::TaskResult<T> {
+            std::coroutine_handle<> continuation;
+
+            Task get_return_object() noexcept {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    std::coroutine_handle<> next = h.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept { return {}; }
+        };
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                if (handle_) handle_.destroy();
+                handle_ = std::exchange(other.handle_, nullptr);
+            }
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task() {
+            if (handle_) handle_.destroy();
+        }
+
+        // Awaiting starts the task; the awaiter resumes when it finishes
+        auto operator co_await() noexcept {
+            struct Awaiter {
+                handle_type h;
+
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+                    h.promise().continuation = caller;
+                    return h;
+                }
+
+                T await_resume() { return h.promise().take(); }
+            };
+            return Awaiter{handle_};
+        }
+
+        // Run from non-coroutine code. Only for tasks that complete
+        // without waiting on anything outside their own call tree.
+        T get() {
+            handle_.resume();
+            assert(handle_.done() && "Task::get() on a task that suspended");
+            return handle_.promise().take();
+        }
+
+        bool done() const noexcept { return handle_.done(); }
+
+    private:
+        explicit Task(handle_type h) noexcept : handle_(h) {}
+
+        handle_type handle_;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+//
+// Coroutine frame resources
+// - Where coroutine frames come from (see coro_task.hpp)
+// - PoolFrameResource: recycling MemoryPools bucketed by frame
+//   size in 64-byte steps; frames above 2 KiB go to operator new
+// - StackFrameResource: a StackAllocator for strictly nested
+//   frames (each frame dies before the one that spawned it, as
+//   in a single-threaded co_await chain); allocate() returns
+//   nullptr when full and the caller falls back to the heap
+// - heap_frame_resource(): global operator new / delete
+// - Each thread has a current resource (the heap by default);
+//   FrameResourceScope swaps it for a scope, e.g. per scheduler
+// - Resources are not thread-safe: frames must be freed on the
+//   thread that allocated them
+// - Part of the optional C++20 allocators_coro target
+//
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include "alloc/memory_pool.hpp"
+#include "alloc/stack_allocator.hpp"
+
+class FrameResource {
+    public:
+        // nullptr means "exhausted, use the heap"; may also throw std::bad_alloc
+        virtual void* allocate(std::size_t n) = 0;
+        virtual void  deallocate(void* p, std::size_t n) noexcept = 0;
+        virtual ~FrameResource() = default;
+};
+
+// Global operator new / delete
+FrameResource& heap_frame_resource() noexcept;
+
+// Resource used by coroutines that are not handed one explicitly
+FrameResource* current_frame_resource() noexcept;
+
+// Returns the previous resource
+FrameResource* set_current_frame_resource(FrameResource* r) noexcept;
+
+class FrameResourceScope {
+    public:
+        explicit FrameResourceScope(FrameResource& r) noexcept
+            : prev_(set_current_frame_resource(&r)) {}
+        ~FrameResourceScope() { set_current_frame_resource(prev_); }
+
+        FrameResourceScope(const FrameResourceScope&) = delete;
+        FrameResourceScope& operator=(const FrameResourceScope&) = delete;
+
+    private:
+        FrameResource* prev_;
+};
+
+class PoolFrameResource : public FrameResource {
+    public:
+        explicit PoolFrameResource(std::size_t frames_per_chunk = 256);
+
+        void* allocate(std::size_t n) override;
+        void  deallocate(void* p, std::size_t n) noexcept override;
+
+        // Release idle chunks of every bucket
+        std::size_t shrink();
+
+    private:
+        static constexpr std::size_t BUCKET_SIZE = 64;
+        static constexpr std::size_t NUM_BUCKETS = 32;     // up to 2 KiB
+
+        std::size_t frames_per_chunk_;
+        std::array<std::unique_ptr<MemoryPool>, NUM_BUCKETS> pools_;
+};
+
+class StackFrameResource : public FrameResource {
+    public:
+        explicit StackFrameResource(std::size_t bytes);
+
+        void* allocate(std::size_t n) override;
+        void  deallocate(void* p, std::size_t n) noexcept override;
+
+        std::size_t remaining() const noexcept { return stack_.remaining(); }
+
+    private:
+        StackAllocator stack_;
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+/* ------------------------------------------
+   GenerationalArena
+   - Ring of K ArenaAllocators ("generations") for pipelines:
+     stage N fills generation k+1 while later stages still read
+     generation k
+   - Each generation carries an atomic reference count; it is
+     reset and reused only once every holder has released it
+   - Lifecycle:
+       producer : g = acquire()       refs = 1, epoch bumped,
+                                      arena reset
+                  g->allocate(...)    fill the batch
+                  g->retain(n)        one reference per consumer
+                  hand g to consumers through any queue
+                  g->release()        drop the producer's own
+       consumer : read, then g->release()
+   - acquire / retain / release are single atomic operations:
+     handing a generation between threads takes no lock, and
+     release/acquire ordering makes the batch contents visible
+   - Memory is allocated once up front: in steady state the
+     pipeline cycles through the same K arenas
+   - Several producers may acquire concurrently; allocation
+     within one generation is single-threaded (like ArenaAllocator)
+   - epoch() identifies a fill of a generation, so a stale
+     holder can be detected with is_current(epoch)
+   - ZeroPolicy::OnReset hands every fill a zeroed arena; the
+     wipe happens in acquire(), on the producer's thread
+-------------------------------------------*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "alloc/arena_allocator.hpp"
+#include "alloc/slot_layout.hpp"
+
+class GenerationalArena {
+    public:
+        class alignas(CACHE_LINE_SIZE) Generation {
+            public:
+                Generation(std::size_t arena_size, ZeroPolicy zero) : arena_(arena_size, zero) {}
+
+                Generation(const Generation&) = delete;
+                Generation& operator=(const Generation&) = delete;
+
+                // Bump allocation inside this generation; nullptr when full
+                void* allocate(std::size_t n, std::size_t alignment = alignof(std::max_align_t)) {
+                    return arena_.allocate(n, alignment);
+                }
+
+                template <class T, class... Args>
+                T* construct(Args&&... args) {
+                    void* p = allocate(sizeof(T), alignof(T));
+                    return p ? ::new (p) T(std::forward<Args>(args)...) : nullptr;
+                }
+
+                void retain(std::uint32_t n = 1) noexcept {
+                    refs_.fetch_add(n, std::memory_order_relaxed);
+                }
+
+                // The last release makes the generation reusable
+                void release() noexcept {
+                    refs_.fetch_sub(1, std::memory_order_acq_rel);
+                }
+
+                std::uint64_t epoch() const noexcept { return epoch_.load(std::memory_order_acquire); }
+                bool is_current(std::uint64_t epoch) const noexcept { return this->epoch() == epoch; }
+
+                std::uint32_t references() const noexcept { return refs_.load(std::memory_order_relaxed); }
+                std::size_t remaining() const noexcept { return arena_.remaining(); }
+
+            private:
+                friend class GenerationalArena;
+
+                ArenaAllocator arena_;
+                std::atomic<std::uint32_t> refs_{0};
+                std::atomic<std::uint64_t> epoch_{0};
+        };
+
+        GenerationalArena(std::size_t arena_size, std::size_t generations,
+                          ZeroPolicy zero = ZeroPolicy::None);
+
+        // Claim the next free generation, reset it and hand it out with
+        // one reference. try_acquire returns nullptr if all K are held;
+        // acquire waits (spinning, then yielding) for a release.
+        Generation* try_acquire() noexcept;
+        Generation* acquire() noexcept;
+
+        std::size_t generations() const noexcept { return ring_.size(); }
+
+        // Generations currently held by someone
+        std::size_t in_use() const noexcept;
+
+    private:
+        std::vector<std::unique_ptr<Generation>> ring_;
+        std::atomic<std::size_t> cursor_{0};        // oldest first
+        std::atomic<std::uint64_t> epoch_{0};
+};
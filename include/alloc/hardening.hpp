@@ -0,0 +1,94 @@
+#pragma once
+
+//
+// Hardening
+// - Compile-time policy, zero cost when off: every hook below is an
+//   empty inline function and `hardening::enabled` is false
+// - ALLOC_HARDENING=1 (CMake: -DALLOC_HARDENED=ON) turns on
+//     - safe-linking of MemoryPool free-list pointers (glibc style)
+//     - free-block canaries and double-free detection in MemoryPool
+//     - double-free / invalid-pointer checks in SlabCache
+//     - StackAllocator::pop marker validation
+// - ALLOC_GUARD_PAGES=1 (CMake: -DALLOC_GUARD_PAGES=ON) maps arena and
+//   stack regions between PROT_NONE guard pages
+// - Under AddressSanitizer, freed blocks and reset arenas are poisoned
+//   so stray accesses are reported (independent of ALLOC_HARDENING)
+// - Violations print a message and abort()
+//
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef ALLOC_HARDENING
+#define ALLOC_HARDENING 0
+#endif
+
+#ifndef ALLOC_GUARD_PAGES
+#define ALLOC_GUARD_PAGES 0
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define ALLOC_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ALLOC_ASAN 1
+#endif
+#endif
+
+#if defined(ALLOC_ASAN)
+#include <sanitizer/asan_interface.h>
+#endif
+
+namespace hardening {
+
+inline constexpr bool enabled = ALLOC_HARDENING != 0;
+inline constexpr bool guard_pages = ALLOC_GUARD_PAGES != 0;
+
+// Report a detected corruption and abort
+[[noreturn]] void fail(const char* what) noexcept;
+
+// Per-process secret mixed into canaries
+std::uintptr_t secret() noexcept;
+
+// Mark [p, p + n) unaddressable / addressable for ASan
+inline void poison(const void* p, std::size_t n) noexcept {
+#if defined(ALLOC_ASAN)
+    ASAN_POISON_MEMORY_REGION(p, n);
+#else
+    (void)p; (void)n;
+#endif
+}
+
+inline void unpoison(const void* p, std::size_t n) noexcept {
+#if defined(ALLOC_ASAN)
+    ASAN_UNPOISON_MEMORY_REGION(p, n);
+#else
+    (void)p; (void)n;
+#endif
+}
+
+// Safe-linking: a stored pointer is XORed with the address of the slot
+// holding it, shifted by the page bits, so a forged or overwritten link
+// decodes to garbage that fails the alignment check.
+template <class T>
+inline T* protect_ptr(const void* slot, T* ptr) noexcept {
+    if constexpr (!enabled) {
+        (void)slot;
+        return ptr;
+    } else {
+        return reinterpret_cast<T*>((reinterpret_cast<std::uintptr_t>(slot) >> 12) ^
+                                    reinterpret_cast<std::uintptr_t>(ptr));
+    }
+}
+
+template <class T>
+inline T* reveal_ptr(const void* slot, T* ptr) noexcept {
+    return protect_ptr(slot, ptr);
+}
+
+// Canary value stored in a free block at address p
+inline std::uintptr_t canary_for(const void* p) noexcept {
+    return secret() ^ reinterpret_cast<std::uintptr_t>(p);
+}
+
+} // namespace hardening
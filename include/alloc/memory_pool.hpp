@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <vector>
 #include <cassert>
+#include "alloc/hardening.hpp"
+#include "alloc/slot_layout.hpp"
 
 //
 // Fixed Memory Pool Allocator
@@ -10,26 +13,97 @@
 // - O(1) alloc/dealloc
 // - Chunk-based automatic expansion
 // - Suitable for small, uniform objects
+// - Optional cache-line aware slot layout (see SlotLayout)
+// - Optional block alignment up to MAX_SLOT_ALIGNMENT: blocks are
+//   rounded to a multiple of it and chunks aligned to it, so every
+//   block is aligned without per-block padding
+// - Fresh chunks are carved lazily by a bump pointer (ascending addresses,
+//   no upfront free-list threading); freed blocks are recycled LIFO
+// - Owned by one thread; other threads free through a lock-free
+//   remote-free list the owner drains when its free list runs dry
+// - Hardened builds (see hardening.hpp) safe-link the free list and
+//   carry a canary in every free block
 //
 
+enum PoolFlags : unsigned {
+    POOL_DEFAULT  = 0,
+    POOL_PREFETCH = 1u << 0,    // prefetch the next free-list node on allocate
+    POOL_PREFAULT = 1u << 1     // map chunks pre-faulted (MAP_POPULATE)
+};
+
 class MemoryPool {
 public:
-    MemoryPool(std::size_t block_size, std::size_t blocks_per_chunk);
+    // alignment: power of two; below max_align_t it is raised to max_align_t
+    MemoryPool(std::size_t block_size, std::size_t blocks_per_chunk,
+               SlotLayout layout = SlotLayout::Packed,
+               unsigned flags = POOL_DEFAULT,
+               std::size_t alignment = alignof(std::max_align_t));
 
     void* allocate();
     void  deallocate(void* ptr);
 
+    // Free a block from a thread other than the owner (lock-free MPSC push)
+    void  deallocate_remote(void* ptr) noexcept;
+
+    // Bulk variants: fill out[0..n) / return in[0..n) in one pass.
+    // The free list is cut / spliced once per segment instead of per block.
+    std::size_t allocate_bulk(void** out, std::size_t n);
+    void        deallocate_bulk(void** in, std::size_t n);
+
+    // Map chunks ahead until at least `blocks` blocks are free, so the
+    // next allocations never grow the pool. With POOL_PREFAULT this moves
+    // the MAP_POPULATE stall of growth out of allocate(). Throws
+    // std::bad_alloc like growth does.
+    void reserve(std::size_t blocks);
+
+    // Effective (rounded) size of each block
+    std::size_t block_size() const noexcept;
+
+    // Alignment every block is guaranteed
+    std::size_t alignment() const noexcept { return alignment_; }
+
+    // Bytes held in chunks but not handed out
+    std::size_t free_bytes() const noexcept;
+
+    // Release fully free chunks until at most max_retained_bytes stay free.
+    // Walks the free list to count free blocks per chunk; O(free * log chunks).
+    // Returns the number of bytes handed back.
+    std::size_t trim(std::size_t max_retained_bytes);
+    std::size_t shrink() { return trim(0); }
+
     ~MemoryPool();
 
 private:
-    struct FreeNode { FreeNode* next; };
+    struct FreeNode {
+        FreeNode* next;             // safe-linked when hardened
+#if ALLOC_HARDENING
+        std::uintptr_t key;         // canary while free
+#endif
+    };
 
+    std::size_t alignment_;
     std::size_t block_size_;
     std::size_t blocks_per_chunk_;
+    std::size_t chunk_alignment_;
+    unsigned flags_;
 
     FreeNode* free_list_ = nullptr;
+    std::atomic<FreeNode*> remote_free_{nullptr};
+    char* bump_ = nullptr;          // next uncarved block of the newest chunk
+    char* bump_end_ = nullptr;      // end of the newest chunk
     std::vector<void*> chunks_;
+    std::vector<void*> spare_chunks_;   // mapped by reserve(), not carved yet
+    std::size_t in_use_ = 0;        // blocks currently handed out
 
-    static std::size_t aligned_block_size(std::size_t size);
+    static std::size_t aligned_block_size(std::size_t size, std::size_t alignment, SlotLayout layout);
+    void* map_chunk();
     void add_chunk();
+    void* carve();
+    bool drain_remote();
+    FreeNode* next_of(const FreeNode* node) const noexcept;
+    void poison_free(FreeNode* node) const noexcept;
+    void push_free(FreeNode* node) noexcept;
+    FreeNode* pop_free() noexcept;
+    void release_chunk(void* chunk);
+    void trim_chunk(void* chunk);
 };
@@ -7,20 +7,27 @@
 // - Automatically grows by allocating new blocks
 // - Zero fragmentation, excellent locality
 // - Ideal for short-lived, bursty allocations
+// - Optional ZeroPolicy (see zeroing.hpp): OnReset hands out memory
+//   that is already zero (new blocks zeroed once, used memory wiped
+//   on reset), OnAllocate zeroes each allocation
 //
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <new>
 #include <memory>
+#include "alloc/zeroing.hpp"
 
 class MonotonicAllocator {
     public:
-        explicit MonotonicAllocator(std::size_t initial_block = 1024);
+        explicit MonotonicAllocator(std::size_t initial_block = 1024,
+                                    ZeroPolicy zero = ZeroPolicy::None);
         void* allocate(std::size_t size, std::size_t alignement = alignof(std::max_align_t));
+        // Keeps the first block, releases the others
         void reset() noexcept;
         std::size_t remaining_in_current_block() const;
-        ~MonotonicAllocator() = default;
+        ~MonotonicAllocator();
 
     private:
         std::byte* start_ = nullptr;
@@ -28,6 +35,7 @@ class MonotonicAllocator {
         std::byte* end_ = nullptr;
 
         std::size_t initial_block_size_;
+        ZeroPolicy zero_;
 
         std::vector<std::unique_ptr<std::byte[]>> blocks_;
         std::vector<std::size_t> block_sizes_;
@@ -0,0 +1,271 @@
+#pragma once
+
+/* ------------------------------------------
+   Offset containers
+   - Position-independent containers for mapped regions
+     (PersistentArena files, shared memory): every internal
+     link is an offset_ptr, so a structure built in one process
+     reads correctly in another that maps it elsewhere
+   - They hold no allocator: growing operations take the arena
+     as an argument (any type with allocate(n, alignment),
+     e.g. PersistentArena, ArenaAllocator, MonotonicAllocator)
+     and throw std::bad_alloc when it is full
+   - Built for monotonic arenas: outgrown buffers are abandoned,
+     never freed, and elements are never destroyed
+   - Read-only access (size, find, iteration) works on a
+     read-only mapping
+   - offset_hash is fixed (splitmix64 / FNV-1a), so hashes
+     stored in a file stay valid across processes and builds
+-------------------------------------------*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "alloc/offset_ptr.hpp"
+
+namespace offset_detail {
+
+template <class T, class Arena>
+T* allocate_array(Arena& arena, std::size_t n) {
+    void* p = arena.allocate(n * sizeof(T), alignof(T));
+    if (!p) throw std::bad_alloc();
+    return static_cast<T*>(p);
+}
+
+} // namespace offset_detail
+
+// Growable array. T must be trivially destructible.
+template <class T>
+class offset_vector {
+    public:
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "elements are never destroyed");
+
+        offset_vector() noexcept = default;
+
+        std::size_t size() const noexcept { return static_cast<std::size_t>(size_); }
+        std::size_t capacity() const noexcept { return static_cast<std::size_t>(capacity_); }
+        bool empty() const noexcept { return size_ == 0; }
+
+        T* data() noexcept { return data_.get(); }
+        const T* data() const noexcept { return data_.get(); }
+
+        T& operator[](std::size_t i) noexcept { return data_[i]; }
+        const T& operator[](std::size_t i) const noexcept { return data_[i]; }
+
+        T& back() noexcept { return data_[size_ - 1]; }
+        const T& back() const noexcept { return data_[size_ - 1]; }
+
+        T* begin() noexcept { return data(); }
+        T* end() noexcept { return data() + size_; }
+        const T* begin() const noexcept { return data(); }
+        const T* end() const noexcept { return data() + size_; }
+
+        template <class Arena>
+        void reserve(Arena& arena, std::size_t n) {
+            if (n <= capacity_) return;
+
+            T* fresh = offset_detail::allocate_array<T>(arena, n);
+            T* old = data_.get();
+            for (std::uint64_t i = 0; i < size_; ++i)
+                ::new (fresh + i) T(std::move(old[i]));
+
+            data_ = fresh;
+            capacity_ = n;
+        }
+
+        // The old buffer outlives growth, so args may alias elements
+        template <class Arena, class... Args>
+        T& emplace_back(Arena& arena, Args&&... args) {
+            if (size_ == capacity_)
+                reserve(arena, capacity_ ? static_cast<std::size_t>(capacity_) * 2 : 8);
+
+            T* slot = ::new (data_.get() + size_) T(std::forward<Args>(args)...);
+            ++size_;
+            return *slot;
+        }
+
+        template <class Arena>
+        void push_back(Arena& arena, const T& value) { emplace_back(arena, value); }
+
+        // Grow or shrink to n elements; new elements are value-initialised
+        template <class Arena>
+        void resize(Arena& arena, std::size_t n) {
+            reserve(arena, n);
+            for (std::uint64_t i = size_; i < n; ++i)
+                ::new (data_.get() + i) T();
+            size_ = n;
+        }
+
+    private:
+        offset_ptr<T> data_;
+        std::uint64_t size_ = 0;
+        std::uint64_t capacity_ = 0;
+};
+
+// Immutable NUL-terminated string stored in the arena
+class offset_string {
+    public:
+        offset_string() noexcept = default;
+
+        template <class Arena>
+        offset_string(Arena& arena, std::string_view s) { assign(arena, s); }
+
+        template <class Arena>
+        void assign(Arena& arena, std::string_view s) {
+            char* p = offset_detail::allocate_array<char>(arena, s.size() + 1);
+            std::memcpy(p, s.data(), s.size());
+            p[s.size()] = '\0';
+            data_ = p;
+            size_ = s.size();
+        }
+
+        std::size_t size() const noexcept { return static_cast<std::size_t>(size_); }
+        bool empty() const noexcept { return size_ == 0; }
+
+        const char* c_str() const noexcept { return data_ ? data_.get() : ""; }
+        std::string_view view() const noexcept { return {c_str(), size()}; }
+        operator std::string_view() const noexcept { return view(); }
+
+        friend bool operator==(const offset_string& a, std::string_view b) noexcept { return a.view() == b; }
+        friend bool operator==(std::string_view a, const offset_string& b) noexcept { return a == b.view(); }
+        friend bool operator==(const offset_string& a, const offset_string& b) noexcept { return a.view() == b.view(); }
+
+    private:
+        offset_ptr<char> data_;
+        std::uint64_t size_ = 0;
+};
+
+// Stable hash for integers, enums and strings (transparent: an
+// offset_string and a string_view with the same text hash alike)
+struct offset_hash {
+    template <class I, std::enable_if_t<std::is_integral_v<I> || std::is_enum_v<I>, int> = 0>
+    std::uint64_t operator()(I value) const noexcept {
+        std::uint64_t x = static_cast<std::uint64_t>(value) + 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    std::uint64_t operator()(std::string_view s) const noexcept {
+        std::uint64_t h = 0xCBF29CE484222325ull;
+        for (unsigned char c : s) {
+            h ^= c;
+            h *= 0x100000001B3ull;
+        }
+        return h;
+    }
+
+    std::uint64_t operator()(const offset_string& s) const noexcept { return (*this)(s.view()); }
+};
+
+//
+// Open-addressing hash map (linear probing, power-of-two capacity,
+// max load 3/4). Insert-only: no erase, as suits a read-mostly index.
+// find() accepts any key type Hash and operator== accept, e.g. a
+// string_view for offset_string keys.
+//
+template <class K, class V, class Hash = offset_hash>
+class offset_hash_map {
+    public:
+        static_assert(std::is_trivially_destructible_v<K> && std::is_trivially_destructible_v<V>,
+                      "entries are never destroyed");
+
+        struct Entry {
+            K key;
+            V value;
+        };
+
+        offset_hash_map() noexcept = default;
+
+        std::size_t size() const noexcept { return static_cast<std::size_t>(size_); }
+        std::size_t capacity() const noexcept { return static_cast<std::size_t>(capacity_); }
+        bool empty() const noexcept { return size_ == 0; }
+
+        template <class Arena>
+        void reserve(Arena& arena, std::size_t n) {
+            std::size_t cap = 16;
+            while (cap * 3 < n * 4) cap <<= 1;
+            if (cap > capacity_) rehash(arena, cap);
+        }
+
+        // Inserts (key, value) unless key is present.
+        // Returns the stored value and whether it was inserted.
+        template <class Arena>
+        std::pair<V*, bool> insert(Arena& arena, const K& key, const V& value) {
+            if ((size_ + 1) * 4 > capacity_ * 3)
+                rehash(arena, capacity_ ? static_cast<std::size_t>(capacity_) * 2 : 16);
+
+            std::size_t i = probe(key);
+            if (ctrl_[i]) return {&entries_[i].value, false};
+
+            ::new (&entries_[i]) Entry{key, value};
+            ctrl_[i] = 1;
+            ++size_;
+            return {&entries_[i].value, true};
+        }
+
+        template <class Q>
+        const V* find(const Q& key) const noexcept {
+            if (size_ == 0) return nullptr;
+            std::size_t i = probe(key);
+            return ctrl_[i] ? &entries_[i].value : nullptr;
+        }
+
+        template <class Q>
+        V* find(const Q& key) noexcept {
+            return const_cast<V*>(static_cast<const offset_hash_map*>(this)->find(key));
+        }
+
+        template <class Q>
+        bool contains(const Q& key) const noexcept { return find(key) != nullptr; }
+
+        // Visit every entry as f(key, value), in slot order
+        template <class F>
+        void for_each(F&& f) const {
+            for (std::uint64_t i = 0; i < capacity_; ++i)
+                if (ctrl_[i]) f(entries_[i].key, entries_[i].value);
+        }
+
+    private:
+        offset_ptr<Entry> entries_;
+        offset_ptr<std::uint8_t> ctrl_;     // 1 = slot in use
+        std::uint64_t size_ = 0;
+        std::uint64_t capacity_ = 0;
+
+        // Slot holding key, or the empty slot where it would go
+        template <class Q>
+        std::size_t probe(const Q& key) const noexcept {
+            std::size_t mask = static_cast<std::size_t>(capacity_) - 1;
+            std::size_t i = static_cast<std::size_t>(Hash{}(key)) & mask;
+            while (ctrl_[i] && !(entries_[i].key == key))
+                i = (i + 1) & mask;
+            return i;
+        }
+
+        template <class Arena>
+        void rehash(Arena& arena, std::size_t cap) {
+            Entry* old_entries = entries_.get();
+            std::uint8_t* old_ctrl = ctrl_.get();
+            std::size_t old_cap = static_cast<std::size_t>(capacity_);
+
+            Entry* fresh = offset_detail::allocate_array<Entry>(arena, cap);
+            std::uint8_t* ctrl = offset_detail::allocate_array<std::uint8_t>(arena, cap);
+            std::memset(ctrl, 0, cap);
+
+            entries_ = fresh;
+            ctrl_ = ctrl;
+            capacity_ = cap;
+
+            for (std::size_t i = 0; i < old_cap; ++i) {
+                if (!old_ctrl[i]) continue;
+                std::size_t j = probe(old_entries[i].key);
+                ::new (&entries_[j]) Entry{old_entries[i].key, old_entries[i].value};
+                ctrl_[j] = 1;
+            }
+        }
+};
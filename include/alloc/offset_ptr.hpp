@@ -0,0 +1,60 @@
+#pragma once
+
+/* ------------------------------------------
+   offset_ptr<T>
+   - Self-relative pointer: stores the distance from its own
+     address to the target instead of an absolute address
+   - Stays valid when the region holding both the pointer and
+     its target is mapped at a different address (files, shm)
+   - Copying recomputes the distance, so offset_ptr must not
+     be memcpy'd to another address
+   - Null is encoded as distance 1 (never a valid target)
+-------------------------------------------*/
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+template <class T>
+class offset_ptr {
+    public:
+        using element_type = T;
+
+        offset_ptr() noexcept = default;
+        offset_ptr(std::nullptr_t) noexcept {}
+        offset_ptr(T* p) noexcept { set(p); }
+        offset_ptr(const offset_ptr& other) noexcept { set(other.get()); }
+
+        template <class U, class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+        offset_ptr(const offset_ptr<U>& other) noexcept { set(other.get()); }
+
+        offset_ptr& operator=(const offset_ptr& other) noexcept { set(other.get()); return *this; }
+        offset_ptr& operator=(T* p) noexcept { set(p); return *this; }
+        offset_ptr& operator=(std::nullptr_t) noexcept { off_ = null_offset; return *this; }
+
+        T* get() const noexcept {
+            if (off_ == null_offset) return nullptr;
+            return reinterpret_cast<T*>(self() + static_cast<std::uintptr_t>(off_));
+        }
+
+        T* operator->() const noexcept { return get(); }
+        T& operator*() const noexcept { return *get(); }
+        T& operator[](std::size_t i) const noexcept { return get()[i]; }
+
+        explicit operator bool() const noexcept { return off_ != null_offset; }
+
+        friend bool operator==(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() == b.get(); }
+        friend bool operator!=(const offset_ptr& a, const offset_ptr& b) noexcept { return a.get() != b.get(); }
+
+    private:
+        static constexpr std::intptr_t null_offset = 1;
+
+        std::intptr_t off_ = null_offset;   // target - this, wrapping
+
+        std::uintptr_t self() const noexcept { return reinterpret_cast<std::uintptr_t>(this); }
+
+        void set(T* p) noexcept {
+            off_ = p ? static_cast<std::intptr_t>(reinterpret_cast<std::uintptr_t>(p) - self())
+                     : null_offset;
+        }
+};
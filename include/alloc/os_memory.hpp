@@ -0,0 +1,36 @@
+#pragma once
+
+//
+// OS Memory helpers
+// - Thin wrappers over the page-level system calls used by the allocators
+// - os_discard hands the physical pages of a span back to the kernel while
+//   the address range stays owned by the caller (MADV_DONTNEED)
+// - os_map / os_unmap give page-aligned anonymous mappings, optionally
+//   pre-faulted (MAP_POPULATE) so first touch never faults
+// - os_map_guarded surrounds a region with PROT_NONE guard pages
+// - No-ops / fallbacks on platforms without madvise
+//
+
+#include <cstddef>
+
+// System page size (cached after the first call)
+std::size_t os_page_size() noexcept;
+
+// Drop the resident pages fully inside [p, p + n). Pages read back as zero.
+// Returns the number of bytes discarded.
+std::size_t os_discard(void* p, std::size_t n) noexcept;
+
+// Anonymous read/write mapping of n bytes, page aligned.
+// populate pre-faults the pages where supported. Returns nullptr on failure.
+void* os_map(std::size_t n, bool populate) noexcept;
+
+// Unmap a region obtained from os_map
+void os_unmap(void* p, std::size_t n) noexcept;
+
+// n usable bytes between two PROT_NONE guard pages. The usable bytes end
+// flush against the trailing guard (n rounded to max_align_t), so a linear
+// overflow faults immediately. Returns nullptr on failure.
+void* os_map_guarded(std::size_t n) noexcept;
+
+// Release a region obtained from os_map_guarded(n)
+void os_unmap_guarded(void* p, std::size_t n) noexcept;
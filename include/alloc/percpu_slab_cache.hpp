@@ -0,0 +1,81 @@
+#pragma once
+
+/* ------------------------------------------
+   PerCpuSlabCache
+   - Thread-safe front-end over a shared SlabCache
+   - One magazine (small object stack) per CPU, not per
+     thread: memory overhead is bounded by the CPU count
+     however many mostly idle threads exist
+   - Current CPU read from the rseq area the C library
+     registers (Linux, glibc >= 2.35); sched_getcpu()
+     otherwise
+   - Each magazine is guarded by its own spin lock, so a
+     thread migrated mid-operation stays correct and only
+     ever contends with the thread now on that CPU
+   - Magazines refill from / spill to the shared depot in
+     batches; spilled objects return to their owning slab
+-------------------------------------------*/
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include "alloc/cache_slab_allocator.hpp"
+#include "alloc/slot_layout.hpp"
+#include "alloc/spin_lock.hpp"
+
+class PerCpuSlabCache {
+    public:
+        /* ------------------------------------------
+        object_size   : size of each object
+        slab_size     : size of each depot slab
+        ctor / dtor   : object-caching hooks (see SlabCache)
+        magazine_size : objects cached per CPU
+        -------------------------------------------*/
+        PerCpuSlabCache(std::size_t object_size,
+                        std::size_t slab_size = 4096,
+                        SlabCache::Ctor ctor = nullptr,
+                        SlabCache::Dtor dtor = nullptr,
+                        std::size_t magazine_size = 64);
+
+        // Any thread may allocate or free, including objects
+        // allocated on another CPU
+        void* allocate();
+        void deallocate(void* ptr);
+
+        // Return every magazine's objects to the depot
+        void flush();
+
+        // Objects currently parked in per-CPU magazines
+        std::size_t cached_objects() const;
+
+        // Bytes of slab memory held by the depot
+        std::size_t slab_bytes() const;
+
+        // Number of per-CPU magazines
+        std::size_t cpu_count() const noexcept { return cpu_count_; }
+
+        // CPU the calling thread is running on
+        static unsigned current_cpu() noexcept;
+
+        // Flushes magazines and frees all slabs
+        ~PerCpuSlabCache();
+
+        PerCpuSlabCache(const PerCpuSlabCache&) = delete;
+        PerCpuSlabCache& operator=(const PerCpuSlabCache&) = delete;
+
+    private:
+        struct alignas(CACHE_LINE_SIZE) Magazine {
+            mutable SpinLock lock;
+            std::size_t count = 0;
+            std::unique_ptr<void*[]> objects;
+        };
+
+        std::size_t magazine_size_;
+        std::size_t cpu_count_;
+        std::unique_ptr<Magazine[]> magazines_;
+
+        mutable std::mutex depot_lock_;
+        SlabCache depot_;
+
+        Magazine& local_magazine() noexcept;
+};
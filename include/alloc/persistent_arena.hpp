@@ -0,0 +1,79 @@
+#pragma once
+
+//
+// Persistent Arena
+// - Bump-pointer arena living inside an mmap'd file
+// - Build a structure once, sync(), and later processes map the
+//   file and use it in place: no parsing, no deserialization
+// - All links inside the region must be offset_ptr (or plain
+//   offsets): the mapping address differs between processes
+// - Fixed capacity chosen at creation; allocate() returns nullptr
+//   when full, like ArenaAllocator
+// - A small header at offset 0 records magic, capacity, the bump
+//   offset and the root object, so the file is self-describing
+// - Modes:
+//     Create    - new file (truncated), MAP_SHARED, read/write
+//     Open      - existing file, MAP_SHARED, read/write
+//     ReadOnly  - existing file, PROT_READ; allocate() is an error
+//     Private   - existing file, MAP_PRIVATE copy-on-write; changes
+//                 stay in this process and never reach the file
+// - Open failures throw std::system_error, foreign or truncated
+//   files throw std::runtime_error
+// - Not thread-safe
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+class PersistentArena {
+    public:
+        enum class Mode { Create, Open, ReadOnly, Private };
+
+        // capacity is only used by Mode::Create (rounded up to a page)
+        PersistentArena(const char* path, Mode mode, std::size_t capacity = 0);
+
+        PersistentArena(const PersistentArena&) = delete;
+        PersistentArena& operator=(const PersistentArena&) = delete;
+
+        // O(1) bump allocation; nullptr when the file is full
+        void* allocate(std::size_t n, std::size_t alignment = alignof(std::max_align_t));
+
+        template <class T, class... Args>
+        T* construct(Args&&... args) {
+            void* p = allocate(sizeof(T), alignof(T));
+            return p ? ::new (p) T(std::forward<Args>(args)...) : nullptr;
+        }
+
+        // Entry point for later processes; stored as an offset
+        void  set_root(const void* p) noexcept;
+        void* root() const noexcept;
+
+        template <class T>
+        T* root_as() const noexcept { return static_cast<T*>(root()); }
+
+        // Offset <-> address translation within this mapping
+        std::size_t offset_of(const void* p) const noexcept;
+        void*       at(std::size_t offset) const noexcept;
+
+        // Flush the used part of a shared mapping to the file (msync).
+        // Returns false for ReadOnly / Private mappings or on error.
+        bool sync(bool async = false) noexcept;
+
+        std::size_t used() const noexcept;
+        std::size_t remaining() const noexcept;
+        std::size_t capacity() const noexcept;
+        bool writable() const noexcept;
+
+        ~PersistentArena();
+
+    private:
+        struct Header;
+
+        std::byte* base_ = nullptr;
+        std::size_t capacity_ = 0;
+        Mode mode_;
+
+        Header* header() const noexcept;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+//
+// Shared Memory Pool
+// - Fixed-size block pool living in a POSIX shared-memory segment
+//   (shm_open + mmap), usable by several processes at once
+// - Fixed capacity: block_count is set at creation, allocate()
+//   returns nullptr when the pool is exhausted
+// - Lock-free Treiber free list of block indices with a 32-bit ABA
+//   tag in the head word; links live in a side array, never inside
+//   blocks, so user writes cannot corrupt the list
+// - No locks are ever held, so a process dying mid-operation cannot
+//   wedge the others
+// - Zero-copy hand-off: send offset_of(block) over any channel, the
+//   receiver turns it back into a pointer with at(offset)
+// - Every allocated block records its owner pid; recover() returns
+//   blocks owned by dead processes. A crash inside allocate() or
+//   deallocate() itself may leak that one block.
+// - adopt() moves ownership to the calling process after a hand-off
+// - A pool object caches the pid of the process that opened it:
+//   after fork(), open the segment again in the child
+// - The segment outlives every handle until unlink(name)
+//
+
+#include <cstddef>
+#include <cstdint>
+#include "alloc/slot_layout.hpp"
+
+class SharedMemoryPool {
+    public:
+        enum class Mode { Create, Open };
+
+        // Create: new segment (fails with EEXIST if the name is taken).
+        // Open: attach to an existing segment; sizes are read from it.
+        SharedMemoryPool(const char* name, Mode mode,
+                         std::size_t block_size = 0, std::size_t block_count = 0,
+                         SlotLayout layout = SlotLayout::Packed);
+
+        SharedMemoryPool(const SharedMemoryPool&) = delete;
+        SharedMemoryPool& operator=(const SharedMemoryPool&) = delete;
+
+        // Lock-free; safe from any thread of any attached process
+        void* allocate() noexcept;
+        void  deallocate(void* ptr) noexcept;
+
+        // Take ownership of a block received from another process
+        void adopt(void* ptr) noexcept;
+
+        // Return blocks whose owner process no longer exists.
+        // Returns the number of blocks reclaimed.
+        std::size_t recover() noexcept;
+
+        // Segment-relative offsets, identical in every process
+        std::uint64_t offset_of(const void* ptr) const noexcept;
+        void*         at(std::uint64_t offset) const noexcept;
+
+        std::size_t block_size() const noexcept;
+        std::size_t block_count() const noexcept;
+
+        // Blocks not owned by anyone (O(block_count) scan; diagnostic)
+        std::size_t free_blocks() const noexcept;
+
+        // Remove the name; existing mappings stay valid
+        static bool unlink(const char* name) noexcept;
+
+        ~SharedMemoryPool();
+
+    private:
+        struct Header;
+
+        std::byte* base_ = nullptr;
+        std::size_t size_ = 0;
+        std::int32_t pid_ = 0;
+
+        Header* header() const noexcept;
+        std::size_t index_of(const void* ptr) const noexcept;
+        void push(std::uint32_t index) noexcept;
+};
@@ -9,14 +9,35 @@
 // - Multiple fixed memory pools for variable small sizes
 // - Power-of-two size classes: 8 → 4096
 // - Lazy pool initialization
+// - Blocks are naturally aligned: each class pool aligns its chunks to
+//   the class size, so a block of class C is aligned to C. A request
+//   for (size, alignment) is served from the class of
+//   max(size, alignment), up to page alignment
 //
 
 class SlabAllocator {
 public:
     explicit SlabAllocator(std::size_t blocks_per_chunk = 1024);
 
-    void* allocate(std::size_t size);
-    void  deallocate(void* ptr, std::size_t size);
+    // Returns nullptr if no class holds max(size, alignment).
+    // Free with the same size and alignment.
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+    void  deallocate(void* ptr, std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    // Bulk variants for n objects of the same size.
+    // allocate_bulk returns the number of objects written (0 if size unsupported).
+    std::size_t allocate_bulk(std::size_t size, void** out, std::size_t n,
+                              std::size_t alignment = alignof(std::max_align_t));
+    void        deallocate_bulk(void** in, std::size_t n, std::size_t size,
+                                std::size_t alignment = alignof(std::max_align_t));
+
+    // Free bytes held across all size-class pools
+    std::size_t free_bytes() const noexcept;
+
+    // Release fully free chunks from the pools (smallest class first keeps
+    // its memory) until at most max_retained_bytes stay free.
+    std::size_t trim(std::size_t max_retained_bytes);
+    std::size_t shrink() { return trim(0); }
 
     ~SlabAllocator();
 
@@ -30,5 +51,6 @@ private:
     std::size_t blocks_per_chunk_;
     std::array<MemoryPool*, NUM_CLASSES> pools_{};
 
-    std::size_t class_index(std::size_t size) const;
+    std::size_t class_index(std::size_t size, std::size_t alignment) const;
+    MemoryPool* pool_for(std::size_t idx);
 };
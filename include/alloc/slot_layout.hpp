@@ -0,0 +1,33 @@
+#pragma once
+
+//
+// Slot Layout
+// - Cache-line constants shared by the fixed-size allocators
+// - SlotLayout selects how fixed-size slots are packed in a chunk/slab
+// - Packed       : densest packing (the historical behaviour)
+// - NoStraddle   : a slot never crosses a cache-line boundary
+// - CacheAligned : every slot owns whole cache lines (no false sharing)
+// - MAX_SLOT_ALIGNMENT bounds the alignment the pools and slabs accept
+//
+
+#include <cstddef>
+
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// One (small) page
+inline constexpr std::size_t MAX_SLOT_ALIGNMENT = 4096;
+
+enum class SlotLayout {
+    Packed,
+    NoStraddle,
+    CacheAligned
+};
+
+// Round a slot size up for the given layout.
+// min_align is the alignment every slot needs regardless of layout.
+std::size_t layout_slot_size(std::size_t size,
+                             std::size_t min_align,
+                             SlotLayout layout) noexcept;
+
+// Alignment the backing chunk/slab must have for the layout to hold
+std::size_t layout_base_alignment(std::size_t min_align, SlotLayout layout) noexcept;
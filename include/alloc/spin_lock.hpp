@@ -0,0 +1,53 @@
+#pragma once
+
+//
+// Spin Lock
+// - Test-and-test-and-set lock for very short critical sections
+// - Satisfies BasicLockable (usable with std::lock_guard)
+// - Fits in one byte; pad the owner to a cache line to avoid false sharing
+// - Yields after a short spin so a preempted holder can make progress
+//
+
+#include <atomic>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+class SpinLock {
+public:
+    void lock() noexcept {
+        while (locked_.exchange(true, std::memory_order_acquire)) {
+            unsigned spins = 0;
+            while (locked_.load(std::memory_order_relaxed)) {
+                if (++spins < SPINS_BEFORE_YIELD) {
+                    pause();
+                } else {
+                    std::this_thread::yield();
+                    spins = 0;
+                }
+            }
+        }
+    }
+
+    bool try_lock() noexcept {
+        return !locked_.load(std::memory_order_relaxed) &&
+               !locked_.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept {
+        locked_.store(false, std::memory_order_release);
+    }
+
+private:
+    static constexpr unsigned SPINS_BEFORE_YIELD = 64;
+
+    std::atomic<bool> locked_{false};
+
+    static void pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    }
+};
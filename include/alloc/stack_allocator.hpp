@@ -7,19 +7,31 @@
 // - O(1) allocate and O(1) pop()
 // - Zero fragmentation
 // - Ideal for nested, scoped temporary allocations
+// - pop() ignores markers above the current top. Hardened builds keep
+//   a shadow stack of the markers push() handed out and abort unless
+//   pop() gets a live frame boundary (catches stale markers too)
+// - ALLOC_GUARD_PAGES builds map the region between guard pages
 //
 
 #include <cstddef>
+#include <cstdint>
 #include <new>
 #include <memory>
+#include <vector>
+#include "alloc/hardening.hpp"
 
 class StackAllocator {
     public:
         using Marker = std::byte*;
         explicit StackAllocator(std::size_t size);
         void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+        // Open a frame; pop(marker) frees it and every frame opened after it
         Marker push() const noexcept;
         void pop(Marker marker) noexcept;
+
+        // Current top, without opening a frame
+        Marker top() const noexcept { return current_; }
+
         std::size_t size() const noexcept;
         std::size_t remaining() const noexcept;
         ~StackAllocator();
@@ -29,6 +41,9 @@ class StackAllocator {
         std::byte* start_;
         std::byte* current_;
         std::byte* end_;
+#if ALLOC_HARDENING
+        mutable std::vector<Marker> frames_;    // markers of the open frames, oldest first
+#endif
 
         static std::byte* align_ptr(std::byte* p, std::size_t alignment) noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+//
+// Trim Policy
+// - Hysteresis for handing idle allocator memory back to the OS
+// - Trimming starts once free bytes exceed high_water and
+//   stops at low_water, so a pool oscillating around one
+//   threshold does not thrash chunk allocation
+// - BackgroundTrimmer runs trim tasks on its own thread,
+//   keeping trimming out of the allocation hot path
+//
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct TrimPolicy {
+    std::size_t high_water;     // trim once free bytes exceed this
+    std::size_t low_water;      // ...down to at most this
+};
+
+// Apply a policy to any allocator exposing free_bytes() / trim(n).
+// Returns the number of bytes released.
+template <class Allocator>
+std::size_t apply_trim_policy(Allocator& allocator, const TrimPolicy& policy) {
+    if (allocator.free_bytes() <= policy.high_water) return 0;
+    return allocator.trim(policy.low_water);
+}
+
+class BackgroundTrimmer {
+public:
+    using Task = std::function<void()>;
+
+    explicit BackgroundTrimmer(std::chrono::milliseconds interval);
+
+    // Register a task run once per interval. The allocators are not
+    // thread-safe: the task must take whatever lock guards the allocator.
+    void add(Task task);
+
+    // Run all tasks now on the trimmer thread
+    void wake();
+
+    // Stop and join the trimmer thread (idempotent)
+    void stop();
+
+    ~BackgroundTrimmer();
+
+    BackgroundTrimmer(const BackgroundTrimmer&) = delete;
+    BackgroundTrimmer& operator=(const BackgroundTrimmer&) = delete;
+
+private:
+    std::chrono::milliseconds interval_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Task> tasks_;
+    bool stopping_ = false;
+    bool woken_ = false;
+
+    std::thread thread_;
+
+    void run();
+};
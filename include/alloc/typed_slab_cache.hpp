@@ -0,0 +1,57 @@
+#pragma once
+
+/* ------------------------------------------
+   TypedSlabCache<T>
+   - Type-safe front-end over SlabCache
+   - T is default-constructed once per slot when a slab
+     is created and destroyed when the slab is reclaimed
+   - allocate() hands out a live T carrying whatever state
+     its previous user left; deallocate() does not destroy it
+   - Suited to objects whose construction is expensive
+     (mutexes, embedded buffers, pre-sized containers)
+   - Over-aligned types (alignas up to a page) are honoured
+-------------------------------------------*/
+
+#include <cstddef>
+#include <new>
+#include "alloc/cache_slab_allocator.hpp"
+
+template <class T>
+class TypedSlabCache {
+    public:
+        static_assert(alignof(T) <= MAX_SLOT_ALIGNMENT,
+                      "SlabCache aligns objects to at most a page");
+
+        explicit TypedSlabCache(std::size_t slab_size = 4096,
+                                SlotLayout layout = SlotLayout::Packed,
+                                bool colouring = false,
+                                bool remote_frees = false)
+            : cache_(sizeof(T), slab_size, &construct, &destroy, layout, colouring, alignof(T),
+                     remote_frees)
+        {}
+
+        T* allocate() { return static_cast<T*>(cache_.allocate()); }
+        void deallocate(T* obj) { cache_.deallocate(obj); }
+
+        std::size_t allocate_bulk(T** out, std::size_t n)
+        {
+            return cache_.allocate_bulk(reinterpret_cast<void**>(out), n);
+        }
+
+        void deallocate_bulk(T** in, std::size_t n)
+        {
+            cache_.deallocate_bulk(reinterpret_cast<void**>(in), n);
+        }
+
+        std::size_t trim(std::size_t max_retained_bytes) { return cache_.trim(max_retained_bytes); }
+        std::size_t shrink() { return cache_.shrink(); }
+        std::size_t free_bytes() const noexcept { return cache_.free_bytes(); }
+
+        SlabCache& raw() noexcept { return cache_; }
+
+    private:
+        static void construct(void* p) { ::new (p) T(); }
+        static void destroy(void* p) { static_cast<T*>(p)->~T(); }
+
+        SlabCache cache_;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+//
+// Zeroing
+// - Zeroing policy for ArenaAllocator, MonotonicAllocator and
+//   GenerationalArena
+//     None           : memory is handed out as is (default)
+//     OnAllocate     : each allocation is zeroed as it is handed out
+//     OnReset        : reset() wipes the used region in one pass, so
+//                      the arena always hands out zeroed memory
+//     ReleaseOnReset : like OnReset, but whole pages are returned to
+//                      the OS (MADV_DONTNEED) and fault back in zeroed
+//                      on first touch. Lowers RSS between fills; a fill
+//                      that reuses most pages pays a fault per page
+// - zero_memory: memset up to zero_stream_threshold(), non-temporal
+//   vector stores above it (AVX-512, AVX2 or SSE2, picked at runtime).
+//   Streaming skips the read-for-ownership and does not flush the
+//   cache, but leaves the lines in memory: it only pays off for spans
+//   larger than the cache a core can use
+// - zero_release: discard whole pages, zero the partial edge pages.
+//   Anonymous private memory only (heap, os_map): a discarded
+//   file-backed page would read back the file contents
+//
+
+#include <cstddef>
+
+enum class ZeroPolicy {
+    None,
+    OnAllocate,
+    OnReset,
+    ReleaseOnReset
+};
+
+// Zero [p, p + n)
+void zero_memory(void* p, std::size_t n) noexcept;
+
+// Zero [p, p + n), handing whole pages back to the OS
+void zero_release(void* p, std::size_t n) noexcept;
+
+// What reset() does with a used region under each policy
+// (nothing for None and OnAllocate)
+void zero_on_reset(ZeroPolicy zero, void* p, std::size_t n) noexcept;
+
+inline bool zeroes_on_reset(ZeroPolicy zero) noexcept {
+    return zero == ZeroPolicy::OnReset || zero == ZeroPolicy::ReleaseOnReset;
+}
+
+// Span size above which zero_memory streams: the last-level cache
+// size, capped at 32 MiB (large server caches are shared by many cores)
+std::size_t zero_stream_threshold() noexcept;
+
+// Store kernel picked for this CPU: "avx512", "avx2", "sse2" or "memset"
+const char* zero_kernel_name() noexcept;
@@ -1,10 +1,32 @@
 #include "alloc/arena_allocator.hpp"
+#include "alloc/hardening.hpp"
+#include "alloc/os_memory.hpp"
 
-ArenaAllocator::ArenaAllocator(std::size_t size) : 
+// The reset policies need the region to start zeroed: take fresh
+// anonymous pages instead of heap memory that may hold old data
+static std::byte* map_region(std::size_t size, ZeroPolicy zero) {
+    void* p;
+    if constexpr (hardening::guard_pages) {
+        p = os_map_guarded(size);
+    } else if (zeroes_on_reset(zero)) {
+        p = os_map(size, false);
+    } else {
+        return static_cast<std::byte*>(::operator new(size));
+    }
+
+    if (!p) throw std::bad_alloc();
+    return static_cast<std::byte*>(p);
+}
+
+ArenaAllocator::ArenaAllocator(std::size_t size, ZeroPolicy zero) : 
                         size_(size),
-                        start_(static_cast<std::byte*>(::operator new (size))),
+                        start_(map_region(size, zero)),
                         current_(start_),
-                        end_(start_ + size) {}
+                        end_(start_ + size),
+                        zero_(zero)
+{
+    hardening::poison(start_, size_);
+}
 
 std::byte* ArenaAllocator::align_ptr(std::byte* ptr, std::size_t alignment) noexcept {
     std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(ptr);
@@ -21,10 +43,22 @@ void* ArenaAllocator::allocate(std::size_t n, std::size_t alignment) {
     if(aligned + n > end_) return nullptr;  // Out of memory
 
     current_ = aligned + n;
+    hardening::unpoison(aligned, n);
+    if (zero_ == ZeroPolicy::OnAllocate) zero_memory(aligned, n);
     return aligned;
 }
 
 void ArenaAllocator::reset() noexcept {
+    std::size_t used = static_cast<std::size_t>(current_ - start_);
+
+    if (zeroes_on_reset(zero_)) {
+        // Alignment gaps are still poisoned
+        hardening::unpoison(start_, used);
+        zero_on_reset(zero_, start_, used);
+    }
+
+    // Everything handed out so far is dead: make stale pointers trap
+    hardening::poison(start_, used);
     current_ = start_;
 }
 
@@ -38,5 +72,13 @@ std::size_t ArenaAllocator::size() const noexcept {
 
 ArenaAllocator::~ArenaAllocator()
 {
-    ::operator delete(start_);
-}
\ No newline at end of file
+    hardening::unpoison(start_, size_);
+
+    if constexpr (hardening::guard_pages) {
+        os_unmap_guarded(start_, size_);
+    } else if (zeroes_on_reset(zero_)) {
+        os_unmap(start_, size_);
+    } else {
+        ::operator delete(start_);
+    }
+}
@@ -1,16 +1,64 @@
 #include "alloc/cache_slab_allocator.hpp"
+#include "alloc/hardening.hpp"
+#include "alloc/os_memory.hpp"
+#include <cstring>
 
 SlabCache::SlabCache(std::size_t object_size,
                     std::size_t slab_size,
                     Ctor ctor,
-                    Dtor dtor)
+                    Dtor dtor,
+                    SlotLayout layout,
+                    bool colouring,
+                    std::size_t alignment,
+                    bool remote_frees)
     : object_size_(object_size),
     slab_size_(slab_size),
     ctor_(ctor),
     dtor_(dtor)
 {
-    objects_per_slab_ = slab_size_ / object_size_;
+    // dtor undoes ctor; without a ctor the slots are never constructed
+    assert((!dtor_ || ctor_) && "dtor requires a matching ctor");
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "alignment must be a power of two");
+    assert(alignment <= MAX_SLOT_ALIGNMENT);
+
+    // Remote frees thread a link word through the slot. A constructed
+    // object must survive being freed, so caches with a ctor (and slots
+    // too small for a pointer) carry the link after the object instead,
+    // and only when asked to: the extra word changes the stride.
+    std::size_t stride = object_size_;
+    link_offset_ = 0;
+    remote_frees_ = !ctor_ && object_size_ >= sizeof(void*);
+    if (remote_frees_)
+    {
+        // Hardened links carry a tag word as well
+        stride = std::max(object_size_, sizeof(RemoteLink));
+    }
+    else if (remote_frees)
+    {
+        // Keep the alignment the packed stride implied for the object
+        std::size_t natural = std::min<std::size_t>(object_size_ & (~object_size_ + 1),
+                                                     alignof(std::max_align_t));
+        link_offset_ = object_size_;
+        stride = (object_size_ + sizeof(RemoteLink) + natural - 1) & ~(natural - 1);
+        remote_frees_ = true;
+    }
+
+    slot_size_ = layout_slot_size(stride, alignment, layout);
+    objects_per_slab_ = slab_size_ / slot_size_;
     assert(objects_per_slab_ > 0 && "slab_size too small for object_size");
+
+    // Colour offsets are only meaningful on a line-aligned slab base
+    slab_alignment_ = std::max(alignment, alignof(std::max_align_t));
+    if (colouring || layout != SlotLayout::Packed)
+        slab_alignment_ = layout_base_alignment(slab_alignment_, SlotLayout::CacheAligned);
+
+    // Colours must keep objects aligned
+    colour_step_ = std::max(alignment, CACHE_LINE_SIZE);
+    if (colouring)
+    {
+        std::size_t leftover = slab_size_ - objects_per_slab_ * slot_size_;
+        colours_ = leftover / colour_step_ + 1;
+    }
 }
 
 SlabCache::~SlabCache()
@@ -22,37 +70,63 @@ SlabCache::~SlabCache()
 
 Slab* SlabCache::create_slab()
 {
-    std::byte* mem = static_cast<std::byte*>(std::malloc(slab_size_));
+    // aligned_alloc wants the size to be a multiple of the alignment
+    std::size_t bytes = (slab_size_ + slab_alignment_ - 1) & ~(slab_alignment_ - 1);
+    std::byte* mem = static_cast<std::byte*>(std::aligned_alloc(slab_alignment_, bytes));
 
     assert(mem && "malloc failed for slab");
 
-    Slab* slab = new Slab(mem, objects_per_slab_);
+    std::byte* first = mem + colour_next_ * colour_step_;
+    colour_next_ = (colour_next_ + 1) % colours_;
+
+    Slab* slab = new Slab(mem, first, objects_per_slab_);
 
     if(ctor_)
     {
         for(std::size_t i = 0; i < objects_per_slab_; ++i) {
-            std::byte* slot = mem + i * object_size_;
+            std::byte* slot = first + i * slot_size_;
             ctor_(static_cast<void*>(slot));
         }
     }
 
-    empty_slabs_.push_back(slab);
+#if ALLOC_HARDENING
+    // Recycled heap memory may still hold a remote-free tag
+    if(remote_frees_)
+    {
+        std::uintptr_t cleared = 0;
+        for(std::size_t i = 0; i < objects_per_slab_; ++i) {
+            std::byte* link = first + i * slot_size_ + link_offset_;
+            std::memcpy(link + offsetof(RemoteLink, key), &cleared, sizeof(cleared));
+        }
+    }
+#endif
+
+    // Free slots are off limits until handed out
+    hardening::poison(mem, slab_size_);
+
+    slab_index_.emplace(mem, slab);
+    slab->list = &empty_slabs_;
+    slab->node = empty_slabs_.insert(empty_slabs_.end(), slab);
     return slab;
 }
 
-void SlabCache::destroy_slab(Slab* slab)
+void SlabCache::destroy_slab(Slab* slab, bool discard)
 {
+    hardening::unpoison(slab->memory, slab_size_);
+
+    // Every slot was constructed in create_slab, free or not
     if(dtor_)
     {
         for (std::size_t i = 0; i < objects_per_slab_; ++i) {
-            if(slab->bitmap[i] == 0)
-            {
-                std::byte* slot = slab->memory + i * object_size_;
-                dtor_(static_cast<void*>(slot));
-            }
+            std::byte* slot = slab->objects + i * slot_size_;
+            dtor_(static_cast<void*>(slot));
         }
     }
 
+    // The C heap may keep a freed slab mapped; drop its pages explicitly
+    if(discard) os_discard(slab->memory, slab_size_);
+
+    slab_index_.erase(slab->memory);
     std::free(slab->memory);
     delete slab;
 }
@@ -67,39 +141,47 @@ void* SlabCache::allocate()
 
         if(slab->free_count == 0)
         {
-            partial_slabs_.pop_front();
-            full_slabs_.push_back(slab);
+            move_to_full(slab);
         }
 
         return ptr;
     }
 
-    // 2) Try empty slabs next
-    if(!empty_slabs_.empty())
+    // 2) Objects freed by other threads, before growing
+    if(empty_slabs_.empty() && drain_remote() > 0)
     {
-        Slab* slab = empty_slabs_.front();
-        empty_slabs_.pop_front();
-        partial_slabs_.push_back(slab);
+        return allocate();
+    }
 
-        return allocate_from_slab(slab);
+    // 3) Take an empty slab, creating one if none is cached
+    //    (create_slab places the new slab on the empty list)
+    if(empty_slabs_.empty())
+    {
+        create_slab();
     }
 
-    // 3) Create a new slab
-    Slab* slab = create_slab();
-    partial_slabs_.push_back(slab);
+    Slab* slab = empty_slabs_.front();
+    void* ptr = allocate_from_slab(slab);
 
-    return allocate_from_slab(slab);
+    if(slab->free_count == 0)
+        move_to_full(slab);
+    else
+        move_to_partial(slab);
+
+    return ptr;
 }
 
 void* SlabCache::allocate_from_slab(Slab* slab)
 {
-    for(std::size_t i = 0; i < objects_per_slab_; ++i) {
+    for(std::size_t i = slab->first_free; i < objects_per_slab_; ++i) {
         if(slab->bitmap[i] == 1)
         {
             slab->bitmap[i] = 0;
             slab->free_count--;
+            slab->first_free = i + 1;
 
-            std::byte* slot = slab->memory + i * object_size_;
+            std::byte* slot = slab->objects + i * slot_size_;
+            hardening::unpoison(slot, slot_size_);
             return static_cast<void*>(slot);
         }
     }
@@ -107,18 +189,161 @@ void* SlabCache::allocate_from_slab(Slab* slab)
     return nullptr;
 }
 
+std::size_t SlabCache::allocate_many_from_slab(Slab* slab, void** out, std::size_t n)
+{
+    std::size_t taken = 0;
+    std::size_t i = slab->first_free;
+
+    for(; i < objects_per_slab_ && taken < n; ++i) {
+        if(slab->bitmap[i] == 1)
+        {
+            slab->bitmap[i] = 0;
+            out[taken++] = static_cast<void*>(slab->objects + i * slot_size_);
+            hardening::unpoison(out[taken - 1], slot_size_);
+        }
+    }
+
+    slab->free_count -= taken;
+    slab->first_free = i;
+    return taken;
+}
+
+std::size_t SlabCache::allocate_bulk(void** out, std::size_t n)
+{
+    std::size_t done = 0;
+
+    // 1) Drain partial slabs
+    while(done < n && !partial_slabs_.empty())
+    {
+        Slab* slab = partial_slabs_.front();
+        done += allocate_many_from_slab(slab, out + done, n - done);
+
+        if(slab->free_count == 0)
+        {
+            move_to_full(slab);
+        }
+    }
+
+    // 2) Then whole empty slabs, creating them as needed
+    //    (after taking back objects freed by other threads)
+    while(done < n)
+    {
+        if(empty_slabs_.empty() && drain_remote() > 0)
+        {
+            return done + allocate_bulk(out + done, n - done);
+        }
+
+        if(empty_slabs_.empty())
+        {
+            create_slab();
+        }
+
+        Slab* slab = empty_slabs_.front();
+        done += allocate_many_from_slab(slab, out + done, n - done);
+
+        if(slab->free_count == 0)
+            move_to_full(slab);
+        else
+            move_to_partial(slab);
+    }
+
+    return done;
+}
+
+void SlabCache::deallocate_bulk(void** in, std::size_t n)
+{
+    // Slabs touched by this batch, marked in place; reclassified
+    // whenever the buffer fills and once at the end
+    constexpr std::size_t MAX_TOUCHED = 32;
+    Slab* touched[MAX_TOUCHED];
+    std::size_t touched_count = 0;
+    Slab* slab = nullptr;
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        std::byte* p = static_cast<std::byte*>(in[i]);
+        if(!p) continue;
+
+        // Consecutive frees usually hit the same slab
+        if(!slab || p < slab->memory || p >= slab->memory + slab_size_)
+        {
+            slab = find_slab_containing(p);
+#if ALLOC_HARDENING
+            if(!slab) hardening::fail("SlabCache: pointer not from this cache");
+#else
+            assert(slab && "Pointer doesn't belong to any slab in this cache");
+#endif
+
+            if(!slab->in_batch)
+            {
+                if(touched_count == MAX_TOUCHED)
+                {
+                    reclassify_batch(touched, touched_count);
+                    touched_count = 0;
+                }
+
+                slab->in_batch = true;
+                slab->batch_free = slab->free_count;
+                touched[touched_count++] = slab;
+            }
+        }
+
+        release_slot(slab, p);
+        slab->free_count++;
+
+        assert(slab->free_count <= objects_per_slab_);
+    }
+
+    reclassify_batch(touched, touched_count);
+}
+
+void SlabCache::reclassify_batch(Slab** touched, std::size_t n)
+{
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        Slab* s = touched[i];
+        s->in_batch = false;
+
+        if(s->free_count == objects_per_slab_)
+            move_to_empty(s);
+        else if(s->batch_free == 0)
+            move_to_partial(s);
+    }
+}
+
+std::size_t SlabCache::release_slot(Slab* slab, std::byte* p)
+{
+    std::size_t offset = static_cast<std::size_t>(p - slab->objects);
+    std::size_t index = offset / slot_size_;
+
+#if ALLOC_HARDENING
+    if(p < slab->objects || offset % slot_size_ != 0 || index >= objects_per_slab_)
+        hardening::fail("SlabCache: pointer is not an object slot");
+    if(slab->bitmap[index] == 1)
+        hardening::fail("SlabCache: double free");
+#else
+    assert(offset % slot_size_ == 0 && index < objects_per_slab_);
+    assert(slab->bitmap[index] == 0 && "double free");
+#endif
+
+    slab->bitmap[index] = 1;
+    slab->first_free = std::min(slab->first_free, index);
+    hardening::poison(p, slot_size_);
+    return index;
+}
+
 void SlabCache::deallocate(void* ptr) 
 {
     if(!ptr) return;
 
     Slab* slab = find_slab_containing(ptr);
+#if ALLOC_HARDENING
+    if(!slab) hardening::fail("SlabCache: pointer not from this cache");
+#else
     assert(slab && "Pointer doesn't belong to any slab in this cache");
+#endif
 
-    std::size_t index = (static_cast<std::byte*>(ptr) - slab->memory) / object_size_;
-
-    if(dtor_) dtor_(ptr);
-
-    slab->bitmap[index] = 1;
+    release_slot(slab, static_cast<std::byte*>(ptr));
     slab->free_count++;
 
     assert(slab->free_count <= objects_per_slab_);
@@ -133,35 +358,122 @@ void SlabCache::deallocate(void* ptr)
     }
 }
 
-Slab* SlabCache::find_slab_containing(void* ptr)
+std::size_t SlabCache::slab_bytes() const noexcept
+{
+    return (empty_slabs_.size() + partial_slabs_.size() + full_slabs_.size()) * slab_size_;
+}
+
+std::size_t SlabCache::free_bytes() const noexcept
 {
-    auto belongs = [&](Slab* s)
+    std::size_t slots = empty_slabs_.size() * objects_per_slab_;
+    for (const Slab* s : partial_slabs_) slots += s->free_count;
+    return slots * slot_size_;
+}
+
+std::size_t SlabCache::trim(std::size_t max_retained_bytes)
+{
+    drain_remote();
+
+    std::size_t retained = free_bytes();
+    std::size_t per_slab = objects_per_slab_ * slot_size_;
+    std::size_t released = 0;
+
+    // Oldest empty slabs go first; recently emptied ones are still warm
+    while (!empty_slabs_.empty() && retained > max_retained_bytes)
     {
-        std::byte* start = s->memory;
-        std::byte* end   = start + slab_size_;
-        return (static_cast<std::byte*>(ptr) >= start &&
-                    static_cast<std::byte*>(ptr) <  end);
-    };
+        Slab* slab = empty_slabs_.front();
+        empty_slabs_.pop_front();
+        destroy_slab(slab, true);
 
-    for (auto* s : partial_slabs_) if (belongs(s)) return s;
-    for (auto* s : full_slabs_)    if (belongs(s)) return s;
-    for (auto* s : empty_slabs_)   if (belongs(s)) return s;
+        retained -= per_slab;
+        released += slab_size_;
+    }
 
-    return nullptr;
+    return released;
+}
+
+void SlabCache::deallocate_remote(void* ptr) noexcept
+{
+    if(!ptr) return;
+
+#if ALLOC_HARDENING
+    if(!remote_frees_)
+        hardening::fail("SlabCache: remote free needs remote_frees");
+#else
+    assert(remote_frees_ && "cache was not created with remote_frees");
+#endif
+
+    std::byte* link = static_cast<std::byte*>(ptr) + link_offset_;
+
+#if ALLOC_HARDENING
+    // Tagged until the owner drains it; a repeat would close a cycle
+    std::uintptr_t tag = hardening::canary_for(link) ^ 1;
+    std::uintptr_t key;
+    std::memcpy(&key, link + offsetof(RemoteLink, key), sizeof(key));
+    if(key == tag) hardening::fail("SlabCache: double remote free");
+    std::memcpy(link + offsetof(RemoteLink, key), &tag, sizeof(tag));
+#endif
+
+    void* head = remote_free_.load(std::memory_order_relaxed);
+
+    do {
+        std::memcpy(link, &head, sizeof(head));
+    } while(!remote_free_.compare_exchange_weak(head, ptr,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
 }
 
-inline void SlabCache::move_to_empty(Slab* slab)
+std::size_t SlabCache::drain_remote()
 {
-    partial_slabs_.remove(slab);
-    full_slabs_.remove(slab);
-    empty_slabs_.remove(slab);
-    empty_slabs_.push_back(slab);
+    if(!remote_free_.load(std::memory_order_relaxed)) return 0;
+
+    void* node = remote_free_.exchange(nullptr, std::memory_order_acquire);
+
+    // Return the batch through the bulk path, one buffer at a time
+    void* batch[64];
+    std::size_t count = 0;
+    std::size_t total = 0;
+
+    while(node)
+    {
+        std::byte* link = static_cast<std::byte*>(node) + link_offset_;
+        void* next;
+        std::memcpy(&next, link, sizeof(next));
+
+#if ALLOC_HARDENING
+        std::uintptr_t cleared = 0;
+        std::memcpy(link + offsetof(RemoteLink, key), &cleared, sizeof(cleared));
+#endif
+
+        batch[count++] = node;
+        if(count == 64)
+        {
+            deallocate_bulk(batch, count);
+            total += count;
+            count = 0;
+        }
+
+        node = next;
+    }
+
+    deallocate_bulk(batch, count);
+    return total + count;
+}
+
+Slab* SlabCache::find_slab_containing(void* ptr)
+{
+    // The last slab starting at or below ptr is the only candidate
+    std::byte* p = static_cast<std::byte*>(ptr);
+    auto it = slab_index_.upper_bound(p);
+    if (it == slab_index_.begin()) return nullptr;
+
+    Slab* s = std::prev(it)->second;
+    return p < s->memory + slab_size_ ? s : nullptr;
 }
 
-void SlabCache::move_to_partial(Slab* slab)
+void SlabCache::move_to(Slab* slab, std::list<Slab*>& to)
 {
-    empty_slabs_.remove(slab);
-    full_slabs_.remove(slab);
-    partial_slabs_.remove(slab); // IMPORTANT
-    partial_slabs_.push_back(slab);
+    // splice keeps slab->node valid, now pointing into `to`
+    to.splice(to.end(), *slab->list, slab->node);
+    slab->list = &to;
 }
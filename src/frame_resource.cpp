@@ -0,0 +1,94 @@
+#include "alloc/frame_resource.hpp"
+#include <cassert>
+#include <new>
+
+namespace {
+
+class HeapFrameResource : public FrameResource {
+    public:
+        void* allocate(std::size_t n) override { return ::operator new(n); }
+        void  deallocate(void* p, std::size_t n) noexcept override { ::operator delete(p, n); }
+};
+
+HeapFrameResource heap_resource;
+thread_local FrameResource* current_resource = &heap_resource;
+
+std::size_t round_frame(std::size_t n) noexcept {
+    return (n + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+}
+
+} // namespace
+
+FrameResource& heap_frame_resource() noexcept {
+    return heap_resource;
+}
+
+FrameResource* current_frame_resource() noexcept {
+    return current_resource;
+}
+
+FrameResource* set_current_frame_resource(FrameResource* r) noexcept {
+    assert(r != nullptr);
+    FrameResource* prev = current_resource;
+    current_resource = r;
+    return prev;
+}
+
+PoolFrameResource::PoolFrameResource(std::size_t frames_per_chunk)
+    : frames_per_chunk_(frames_per_chunk)
+{}
+
+void* PoolFrameResource::allocate(std::size_t n) {
+    std::size_t idx = (n - 1) / BUCKET_SIZE;
+    if (idx >= NUM_BUCKETS) return ::operator new(n);
+
+    // A coroutine type always has the same frame size, so each
+    // bucket quickly settles into a steady recycle loop
+    if (!pools_[idx])
+        pools_[idx] = std::make_unique<MemoryPool>((idx + 1) * BUCKET_SIZE, frames_per_chunk_);
+
+    return pools_[idx]->allocate();
+}
+
+void PoolFrameResource::deallocate(void* p, std::size_t n) noexcept {
+    std::size_t idx = (n - 1) / BUCKET_SIZE;
+    if (idx >= NUM_BUCKETS) {
+        ::operator delete(p, n);
+        return;
+    }
+
+    assert(pools_[idx]);
+    pools_[idx]->deallocate(p);
+}
+
+std::size_t PoolFrameResource::shrink() {
+    std::size_t released = 0;
+    for (auto& pool : pools_)
+        if (pool) released += pool->shrink();
+    return released;
+}
+
+StackFrameResource::StackFrameResource(std::size_t bytes)
+    : stack_(bytes)
+{}
+
+void* StackFrameResource::allocate(std::size_t n) {
+    // Each frame is a stack frame of its own, so pop() sees its marker
+    StackAllocator::Marker frame = stack_.push();
+    void* p = stack_.allocate(round_frame(n), alignof(std::max_align_t));
+    if (!p) {
+        stack_.pop(frame);
+        return nullptr;
+    }
+
+    assert(p == frame && "frames stay max_align_t aligned");
+    return p;
+}
+
+void StackFrameResource::deallocate(void* p, std::size_t n) noexcept {
+    // Strict nesting: only the most recent frame may die
+    assert(static_cast<std::byte*>(p) + round_frame(n) == stack_.top() &&
+           "StackFrameResource: frames freed out of order");
+    (void)n;
+    stack_.pop(static_cast<std::byte*>(p));
+}
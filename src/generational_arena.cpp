@@ -0,0 +1,51 @@
+#include "alloc/generational_arena.hpp"
+#include <cassert>
+#include <thread>
+
+GenerationalArena::GenerationalArena(std::size_t arena_size, std::size_t generations,
+                                     ZeroPolicy zero)
+{
+    assert(generations > 0);
+
+    ring_.reserve(generations);
+    for (std::size_t i = 0; i < generations; ++i)
+        ring_.push_back(std::make_unique<Generation>(arena_size, zero));
+}
+
+GenerationalArena::Generation* GenerationalArena::try_acquire() noexcept {
+    std::size_t k = ring_.size();
+    std::size_t start = cursor_.load(std::memory_order_relaxed);
+
+    // Ring order reuses the generation released longest ago first
+    for (std::size_t i = 0; i < k; ++i) {
+        Generation* g = ring_[(start + i) % k].get();
+
+        std::uint32_t free = 0;
+        if (!g->refs_.compare_exchange_strong(free, 1, std::memory_order_acquire,
+                                              std::memory_order_relaxed))
+            continue;
+
+        // Every reader of the previous fill has released it
+        g->arena_.reset();
+        g->epoch_.store(epoch_.fetch_add(1, std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+        cursor_.store((start + i + 1) % k, std::memory_order_relaxed);
+        return g;
+    }
+
+    return nullptr;
+}
+
+GenerationalArena::Generation* GenerationalArena::acquire() noexcept {
+    for (unsigned spins = 0;; ++spins) {
+        if (Generation* g = try_acquire()) return g;
+        if (spins >= 64) std::this_thread::yield();
+    }
+}
+
+std::size_t GenerationalArena::in_use() const noexcept {
+    std::size_t n = 0;
+    for (const auto& g : ring_)
+        if (g->references() != 0) ++n;
+    return n;
+}
@@ -0,0 +1,28 @@
+#include "alloc/hardening.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace hardening {
+
+void fail(const char* what) noexcept {
+    std::fprintf(stderr, "alloc: fatal: %s\n", what);
+    std::abort();
+}
+
+std::uintptr_t secret() noexcept {
+    // ASLR'd address mixed with a timestamp; only needs to be unguessable
+    // by a stray write, not cryptographically strong
+    static const std::uintptr_t value = [] {
+        static int anchor;
+        std::uintptr_t v = reinterpret_cast<std::uintptr_t>(&anchor);
+        v ^= static_cast<std::uintptr_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+        v *= 0x9E3779B97F4A7C15ull;
+        return v | 1;
+    }();
+    return value;
+}
+
+} // namespace hardening
@@ -0,0 +1,451 @@
+//
+// malloc / operator new replacement (liballocators_malloc.so)
+// - LD_PRELOAD=liballocators_malloc.so <program> runs an unmodified
+//   program on this library's allocators
+// - Small requests (<= 4 KiB with header) go to one of SHARDS
+//   SlabAllocators, each behind a SpinLock; a thread sticks to the
+//   shard it was given round-robin on its first allocation, frees
+//   lock the shard recorded in the block header
+// - Over-aligned requests that fit with their alignment padding use a
+//   slab class too (slab blocks are naturally aligned)
+// - Larger requests go to a page tier: one mmap per block, with a
+//   small cache of recently freed spans up to 128 KiB
+// - Every block carries a 16-byte header (tier tag, shard, size),
+//   so free / realloc / malloc_usable_size need no lookup
+// - Early init: all state is constant-initialised or placement-
+//   constructed on first use; nothing runs before main
+// - Re-entrancy: the allocators themselves call operator new for
+//   their own bookkeeping and chunks; an initial-exec thread_local
+//   flag sends those nested calls straight to the page tier
+// - fork: pthread_atfork takes every lock before fork and releases
+//   it in both parent and child
+//
+
+#include "alloc/os_memory.hpp"
+#include "alloc/slab_allocator.hpp"
+#include "alloc/spin_lock.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <mutex>
+#include <new>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#define SHIM_EXPORT extern "C" __attribute__((visibility("default")))
+#define SHIM_TLS __attribute__((tls_model("initial-exec")))
+
+namespace {
+
+constexpr std::size_t HEADER = 16;
+constexpr std::size_t SMALL_MAX = 4096;             // largest SlabAllocator class
+constexpr std::size_t SHARDS = 16;
+constexpr std::size_t BLOCKS_PER_CHUNK = 256;
+
+constexpr std::uint32_t TAG_MASK = 0xffffff00u;
+constexpr std::uint32_t SMALL_TAG = 0x5a110c00u;    // | shard
+constexpr std::uint32_t PAGE_TAG = 0x9a6e0000u;
+
+struct Header {
+    std::uint32_t tier;
+    std::uint32_t offset;       // header - block / mapping start
+    std::uint64_t size;         // small: class size, page: mapping length
+};
+
+static_assert(sizeof(Header) == HEADER, "header must keep 16-byte alignment");
+
+// ---------------------------------------------------------------- small tier
+
+struct alignas(CACHE_LINE_SIZE) Shard {
+    SpinLock lock;
+    alignas(SlabAllocator) unsigned char storage[sizeof(SlabAllocator)];
+
+    SlabAllocator& slab() noexcept { return *reinterpret_cast<SlabAllocator*>(storage); }
+};
+
+Shard shards[SHARDS];
+std::atomic<int> init_state{0};             // 0 = none, 1 = running, 2 = done
+std::atomic<unsigned> next_shard{0};
+
+thread_local bool in_shim SHIM_TLS = false;
+thread_local unsigned my_shard SHIM_TLS = 0;     // index + 1, 0 = unassigned
+
+struct ReentryGuard {
+    bool prev = in_shim;
+    ReentryGuard() noexcept { in_shim = true; }
+    ~ReentryGuard() { in_shim = prev; }
+};
+
+std::size_t small_class(std::size_t n) noexcept {
+    std::size_t c = 16;
+    while (c < n) c <<= 1;
+    return c;
+}
+
+// ---------------------------------------------------------------- page tier
+
+// Freed spans of 1..CACHED_PAGES pages are kept for reuse; the first
+// word of a cached span links to the next one
+constexpr std::size_t CACHED_PAGES = 32;
+constexpr std::size_t CACHED_PER_SIZE = 8;
+
+struct PageCache {
+    SpinLock lock;
+    void* heads[CACHED_PAGES + 1] = {};
+    std::uint32_t counts[CACHED_PAGES + 1] = {};
+};
+
+PageCache page_cache;
+
+void lock_all() noexcept {
+    for (Shard& s : shards) s.lock.lock();
+    page_cache.lock.lock();
+}
+
+void unlock_all() noexcept {
+    page_cache.lock.unlock();
+    for (Shard& s : shards) s.lock.unlock();
+}
+
+void ensure_init() noexcept {
+    if (init_state.load(std::memory_order_acquire) == 2) return;
+
+    int expected = 0;
+    if (init_state.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+        for (Shard& s : shards) ::new (s.storage) SlabAllocator(BLOCKS_PER_CHUNK);
+        init_state.store(2, std::memory_order_release);
+
+        // May allocate: the shards are ready by now
+        pthread_atfork(lock_all, unlock_all, unlock_all);
+        return;
+    }
+
+    while (init_state.load(std::memory_order_acquire) != 2) {
+        // Another thread is constructing the shards (no allocation involved)
+    }
+}
+
+void* page_alloc(std::size_t n, std::size_t align, bool* fresh) noexcept {
+    std::size_t page = os_page_size();
+    std::size_t gap = align > HEADER ? align : HEADER;
+    if (n > SIZE_MAX - gap - page) return nullptr;
+
+    std::size_t len = (n + gap + page - 1) & ~(page - 1);
+    std::size_t pages = len / page;
+
+    std::byte* base = nullptr;
+    *fresh = false;
+
+    if (pages <= CACHED_PAGES) {
+        std::lock_guard<SpinLock> g(page_cache.lock);
+        if (void* span = page_cache.heads[pages]) {
+            page_cache.heads[pages] = *static_cast<void**>(span);
+            --page_cache.counts[pages];
+            base = static_cast<std::byte*>(span);
+        }
+    }
+
+    if (!base) {
+        base = static_cast<std::byte*>(os_map(len, false));
+        if (!base) return nullptr;
+        *fresh = true;
+    }
+
+    std::uintptr_t user = (reinterpret_cast<std::uintptr_t>(base) + HEADER + gap - 1) & ~(gap - 1);
+
+    Header* h = reinterpret_cast<Header*>(user - HEADER);
+    h->tier = PAGE_TAG;
+    h->offset = static_cast<std::uint32_t>(reinterpret_cast<std::byte*>(h) - base);
+    h->size = len;
+    return reinterpret_cast<void*>(user);
+}
+
+void page_free(Header* h) noexcept {
+    std::byte* base = reinterpret_cast<std::byte*>(h) - h->offset;
+    std::size_t len = static_cast<std::size_t>(h->size);
+    std::size_t pages = len / os_page_size();
+
+    if (pages <= CACHED_PAGES) {
+        std::lock_guard<SpinLock> g(page_cache.lock);
+        if (page_cache.counts[pages] < CACHED_PER_SIZE) {
+            *reinterpret_cast<void**>(base) = page_cache.heads[pages];
+            page_cache.heads[pages] = base;
+            ++page_cache.counts[pages];
+            return;
+        }
+    }
+
+    os_unmap(base, len);
+}
+
+// ---------------------------------------------------------------- front end
+
+Header* header_of(void* p) noexcept {
+    return reinterpret_cast<Header*>(static_cast<std::byte*>(p) - HEADER);
+}
+
+[[noreturn]] void bad_pointer() noexcept {
+    static const char msg[] = "alloc: fatal: free() of a pointer not from this allocator\n";
+    std::fwrite(msg, 1, sizeof(msg) - 1, stderr);
+    std::abort();
+}
+
+// Slab blocks are aligned to their class size: an over-aligned request
+// takes a class of at least n + align and puts the user pointer align
+// bytes in, with the header just before it
+void* small_alloc(std::size_t n, std::size_t align) noexcept {
+    ensure_init();
+
+    if (my_shard == 0)
+        my_shard = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS + 1;
+    unsigned idx = my_shard - 1;
+    Shard& s = shards[idx];
+
+    std::size_t gap = align > HEADER ? align : HEADER;
+    std::size_t cls = small_class(n + gap);
+    void* block = nullptr;
+    {
+        ReentryGuard guard;
+        std::lock_guard<SpinLock> g(s.lock);
+        try {
+            block = s.slab().allocate(cls);
+        } catch (const std::bad_alloc&) {
+            block = nullptr;
+        }
+    }
+    if (!block) return nullptr;
+
+    std::byte* user = static_cast<std::byte*>(block) + gap;
+    Header* h = header_of(user);
+    h->tier = SMALL_TAG | idx;
+    h->offset = static_cast<std::uint32_t>(gap - HEADER);
+    h->size = cls;
+    return user;
+}
+
+void* shim_malloc(std::size_t n, bool* fresh) noexcept {
+    *fresh = false;
+
+    if (n <= SMALL_MAX - HEADER && !in_shim)
+        return small_alloc(n, HEADER);
+
+    return page_alloc(n, HEADER, fresh);
+}
+
+void* shim_malloc(std::size_t n) noexcept {
+    bool fresh;
+    return shim_malloc(n, &fresh);
+}
+
+void* shim_aligned(std::size_t align, std::size_t n) noexcept {
+    // Small blocks and headers keep 16-byte alignment
+    if (align <= HEADER) return shim_malloc(n);
+
+    if (align < SMALL_MAX && n <= SMALL_MAX - align && !in_shim)
+        return small_alloc(n, align);
+
+    bool fresh;
+    return page_alloc(n, align, &fresh);
+}
+
+void shim_free(void* p) noexcept {
+    if (!p) return;
+
+    Header* h = header_of(p);
+
+    if ((h->tier & TAG_MASK) == SMALL_TAG) {
+        Shard& s = shards[h->tier & 0xffu];
+        std::size_t cls = static_cast<std::size_t>(h->size);
+        std::byte* block = reinterpret_cast<std::byte*>(h) - h->offset;
+
+        ReentryGuard guard;
+        std::lock_guard<SpinLock> g(s.lock);
+        s.slab().deallocate(block, cls);
+        return;
+    }
+
+    if (h->tier == PAGE_TAG) {
+        page_free(h);
+        return;
+    }
+
+    bad_pointer();
+}
+
+std::size_t shim_usable(void* p) noexcept {
+    if (!p) return 0;
+    Header* h = header_of(p);
+    return static_cast<std::size_t>(h->size) - h->offset - HEADER;
+}
+
+void* shim_realloc(void* p, std::size_t n) noexcept {
+    if (!p) return shim_malloc(n);
+    if (n == 0) {
+        shim_free(p);
+        return nullptr;
+    }
+
+    std::size_t usable = shim_usable(p);
+    if (n <= usable) return p;
+
+#if defined(MREMAP_MAYMOVE)
+    // Large unaligned blocks grow in place or move without copying
+    Header* h = header_of(p);
+    if (h->tier == PAGE_TAG && h->offset == 0 && n > SMALL_MAX) {
+        std::size_t page = os_page_size();
+        std::size_t len = (n + HEADER + page - 1) & ~(page - 1);
+        void* base = mremap(h, static_cast<std::size_t>(h->size), len, MREMAP_MAYMOVE);
+        if (base == MAP_FAILED) return nullptr;
+        static_cast<Header*>(base)->size = len;
+        return static_cast<std::byte*>(base) + HEADER;
+    }
+#endif
+
+    void* q = shim_malloc(n);
+    if (!q) return nullptr;
+    std::memcpy(q, p, usable);
+    shim_free(p);
+    return q;
+}
+
+void* new_impl(std::size_t n, std::size_t align) {
+    for (;;) {
+        void* p = align ? shim_aligned(align, n) : shim_malloc(n);
+        if (p) return p;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* new_nothrow(std::size_t n, std::size_t align) noexcept {
+    try {
+        return new_impl(n, align);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------- C API
+
+SHIM_EXPORT void* malloc(std::size_t n) noexcept {
+    void* p = shim_malloc(n);
+    if (!p) errno = ENOMEM;
+    return p;
+}
+
+SHIM_EXPORT void free(void* p) noexcept {
+    shim_free(p);
+}
+
+SHIM_EXPORT void* calloc(std::size_t count, std::size_t size) noexcept {
+    std::size_t n;
+    if (__builtin_mul_overflow(count, size, &n)) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+
+    bool fresh;
+    void* p = shim_malloc(n, &fresh);
+    if (!p) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+
+    // Fresh mappings are already zero
+    if (!fresh) std::memset(p, 0, n);
+    return p;
+}
+
+SHIM_EXPORT void* realloc(void* p, std::size_t n) noexcept {
+    void* q = shim_realloc(p, n);
+    if (!q && n) errno = ENOMEM;
+    return q;
+}
+
+SHIM_EXPORT void* reallocarray(void* p, std::size_t count, std::size_t size) noexcept {
+    std::size_t n;
+    if (__builtin_mul_overflow(count, size, &n)) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    return realloc(p, n);
+}
+
+SHIM_EXPORT int posix_memalign(void** out, std::size_t align, std::size_t n) noexcept {
+    if (align < sizeof(void*) || (align & (align - 1)) != 0) return EINVAL;
+
+    void* p = shim_aligned(align, n);
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+SHIM_EXPORT void* aligned_alloc(std::size_t align, std::size_t n) noexcept {
+    if (align == 0 || (align & (align - 1)) != 0) {
+        errno = EINVAL;
+        return nullptr;
+    }
+
+    void* p = shim_aligned(align, n);
+    if (!p) errno = ENOMEM;
+    return p;
+}
+
+SHIM_EXPORT void* memalign(std::size_t align, std::size_t n) noexcept {
+    return aligned_alloc(align, n);
+}
+
+SHIM_EXPORT void* valloc(std::size_t n) noexcept {
+    return aligned_alloc(os_page_size(), n);
+}
+
+SHIM_EXPORT void* pvalloc(std::size_t n) noexcept {
+    std::size_t page = os_page_size();
+    return aligned_alloc(page, (n + page - 1) & ~(page - 1));
+}
+
+SHIM_EXPORT std::size_t malloc_usable_size(void* p) noexcept {
+    return shim_usable(p);
+}
+
+// ---------------------------------------------------------------- C++ API
+
+void* operator new(std::size_t n) { return new_impl(n, 0); }
+void* operator new[](std::size_t n) { return new_impl(n, 0); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return new_nothrow(n, 0); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return new_nothrow(n, 0); }
+
+void* operator new(std::size_t n, std::align_val_t a) {
+    return new_impl(n, static_cast<std::size_t>(a));
+}
+void* operator new[](std::size_t n, std::align_val_t a) {
+    return new_impl(n, static_cast<std::size_t>(a));
+}
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return new_nothrow(n, static_cast<std::size_t>(a));
+}
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return new_nothrow(n, static_cast<std::size_t>(a));
+}
+
+void operator delete(void* p) noexcept { shim_free(p); }
+void operator delete[](void* p) noexcept { shim_free(p); }
+void operator delete(void* p, std::size_t) noexcept { shim_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { shim_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { shim_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { shim_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { shim_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { shim_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { shim_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { shim_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { shim_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { shim_free(p); }
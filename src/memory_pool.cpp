@@ -1,57 +1,397 @@
 #include "alloc/memory_pool.hpp"
+#include "alloc/hardening.hpp"
+#include "alloc/os_memory.hpp"
 #include <new>
 #include <algorithm>
+#include <cstdint>
 
-MemoryPool::MemoryPool(std::size_t block_size, std::size_t blocks_per_chunk)
-    : block_size_(aligned_block_size(block_size)),
-      blocks_per_chunk_(blocks_per_chunk)
+MemoryPool::MemoryPool(std::size_t block_size, std::size_t blocks_per_chunk,
+                       SlotLayout layout, unsigned flags, std::size_t alignment)
+    : alignment_(std::max(alignment, alignof(std::max_align_t))),
+      block_size_(aligned_block_size(block_size, alignment_, layout)),
+      blocks_per_chunk_(blocks_per_chunk),
+      chunk_alignment_(layout_base_alignment(alignment_, layout)),
+      flags_(flags)
 {
     assert(block_size > 0);
     assert(blocks_per_chunk > 0);
+    assert((alignment & (alignment - 1)) == 0 && "alignment must be a power of two");
+    assert(alignment <= MAX_SLOT_ALIGNMENT);
     add_chunk();
 }
 
-std::size_t MemoryPool::aligned_block_size(std::size_t size) {
+std::size_t MemoryPool::aligned_block_size(std::size_t size, std::size_t alignment, SlotLayout layout) {
     std::size_t min = std::max(size, sizeof(FreeNode));
-    std::size_t alignment = alignof(std::max_align_t);
-    return (min + alignment - 1) & ~(alignment - 1);
+    return layout_slot_size(min, alignment, layout);
 }
 
-void MemoryPool::add_chunk() {
+void* MemoryPool::map_chunk() {
     std::size_t chunk_size = block_size_ * blocks_per_chunk_;
-    void* chunk = ::operator new(chunk_size);
+    void* chunk;
+
+    if (flags_ & POOL_PREFAULT) {
+        // Page-aligned, already backed: no first-touch faults on the hot path
+        chunk = os_map(chunk_size, true);
+        if (!chunk) throw std::bad_alloc();
+    } else {
+        chunk = ::operator new(chunk_size, std::align_val_t{chunk_alignment_});
+    }
 
-    chunks_.push_back(chunk);
+    hardening::poison(chunk, chunk_size);
+    return chunk;
+}
 
-    char* p = static_cast<char*>(chunk);
-    for (std::size_t i = 0; i < blocks_per_chunk_; ++i) {
-        FreeNode* node = reinterpret_cast<FreeNode*>(p);
-        node->next = free_list_;
-        free_list_ = node;
-        p += block_size_;
+void MemoryPool::add_chunk() {
+    void* chunk;
+
+    // A chunk mapped ahead by reserve() costs nothing here
+    if (!spare_chunks_.empty()) {
+        chunk = spare_chunks_.back();
+        spare_chunks_.pop_back();
+    } else {
+        chunks_.reserve(chunks_.size() + 1);
+        chunk = map_chunk();
+        chunks_.push_back(chunk);
     }
+
+    // Blocks are carved on demand; nothing is threaded up front
+    bump_ = static_cast<char*>(chunk);
+    bump_end_ = bump_ + block_size_ * blocks_per_chunk_;
 }
 
-void* MemoryPool::allocate() {
-    if (!free_list_) {
-        add_chunk();
+void MemoryPool::reserve(std::size_t blocks) {
+    std::size_t free = free_bytes() / block_size_;
+    if (free >= blocks) return;
+
+    std::size_t missing = (blocks - free + blocks_per_chunk_ - 1) / blocks_per_chunk_;
+    chunks_.reserve(chunks_.size() + missing);
+    spare_chunks_.reserve(spare_chunks_.size() + missing);
+
+    for (std::size_t i = 0; i < missing; ++i) {
+        void* chunk = map_chunk();
+        chunks_.push_back(chunk);
+        spare_chunks_.push_back(chunk);
+    }
+}
+
+MemoryPool::FreeNode* MemoryPool::next_of(const FreeNode* node) const noexcept {
+    return hardening::reveal_ptr(&node->next, node->next);
+}
+
+void MemoryPool::poison_free(FreeNode* node) const noexcept {
+    // The link header stays addressable; in hardened builds the canary guards it
+    hardening::poison(reinterpret_cast<char*>(node) + sizeof(FreeNode),
+                      block_size_ - sizeof(FreeNode));
+}
+
+void MemoryPool::push_free(FreeNode* node) noexcept {
+#if ALLOC_HARDENING
+    // A free block carries its canary: seeing it again is either a
+    // double free or user data that happens to match; the list decides
+    if (node->key == hardening::canary_for(node)) {
+        for (FreeNode* n = free_list_; n; n = next_of(n))
+            if (n == node) hardening::fail("MemoryPool: double free");
     }
+    node->key = hardening::canary_for(node);
+#endif
 
+    node->next = hardening::protect_ptr(&node->next, free_list_);
+    free_list_ = node;
+    poison_free(node);
+}
+
+MemoryPool::FreeNode* MemoryPool::pop_free() noexcept {
     FreeNode* node = free_list_;
-    free_list_ = node->next;
+    hardening::unpoison(node, block_size_);
+
+#if ALLOC_HARDENING
+    if (node->key != hardening::canary_for(node))
+        hardening::fail("MemoryPool: free block overwritten (use after free?)");
+    node->key = 0;
+#endif
+
+    free_list_ = next_of(node);
+
+#if ALLOC_HARDENING
+    if (reinterpret_cast<std::uintptr_t>(free_list_) % alignment_ != 0)
+        hardening::fail("MemoryPool: corrupted free list");
+#endif
+
     return node;
 }
 
+bool MemoryPool::drain_remote() {
+    if (!remote_free_.load(std::memory_order_relaxed)) return false;
+
+    FreeNode* head = remote_free_.exchange(nullptr, std::memory_order_acquire);
+    if (!head) return false;
+
+    std::size_t n = 0;
+
+#if ALLOC_HARDENING
+    // Remote links are raw; re-link each block through the checked path
+    while (head) {
+        FreeNode* next = head->next;
+        head->key = 0;
+        push_free(head);
+        head = next;
+        ++n;
+    }
+#else
+    // Splice the whole batch in front of the local list
+    FreeNode* tail = head;
+    n = 1;
+    poison_free(tail);
+    while (tail->next) {
+        tail = tail->next;
+        poison_free(tail);
+        ++n;
+    }
+
+    tail->next = free_list_;
+    free_list_ = head;
+#endif
+
+    in_use_ -= n;
+    return true;
+}
+
+void* MemoryPool::carve() {
+    if (bump_ == bump_end_) {
+        add_chunk();
+    }
+
+    void* p = bump_;
+    bump_ += block_size_;
+    hardening::unpoison(p, block_size_);
+
+#if ALLOC_HARDENING
+    // Recycled heap memory may still hold a remote-free tag
+    static_cast<FreeNode*>(p)->key = 0;
+#endif
+    return p;
+}
+
+void* MemoryPool::allocate() {
+    // Recycled blocks first: they are the most recently touched
+    if (free_list_ || drain_remote()) {
+        FreeNode* node = pop_free();
+
+        if ((flags_ & POOL_PREFETCH) && free_list_) {
+            __builtin_prefetch(free_list_);
+        }
+
+        ++in_use_;
+        return node;
+    }
+
+    // Counted only once carved: add_chunk() may throw
+    void* p = carve();
+    ++in_use_;
+    return p;
+}
+
 void MemoryPool::deallocate(void* ptr) {
     assert(ptr != nullptr);
 
+    push_free(static_cast<FreeNode*>(ptr));
+    --in_use_;
+}
+
+void MemoryPool::deallocate_remote(void* ptr) noexcept {
+    assert(ptr != nullptr);
+
     FreeNode* node = static_cast<FreeNode*>(ptr);
-    node->next = free_list_;
-    free_list_ = node;
+
+#if ALLOC_HARDENING
+    // Tagged apart from the local canary until the owner drains it
+    std::uintptr_t tag = hardening::canary_for(node) ^ 1;
+    if (node->key == tag) hardening::fail("MemoryPool: double remote free");
+    node->key = tag;
+#endif
+
+    node->next = remote_free_.load(std::memory_order_relaxed);
+
+    while (!remote_free_.compare_exchange_weak(node->next, node,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+    }
+}
+
+std::size_t MemoryPool::allocate_bulk(void** out, std::size_t n) {
+    std::size_t i = 0;
+
+    try {
+        for (;;) {
+            std::size_t first = i;
+
+#if ALLOC_HARDENING
+            while (free_list_ && i < n) {
+                out[i++] = pop_free();
+            }
+#else
+            // Walk a segment of the list, then cut it once
+            FreeNode* node = free_list_;
+            while (node && i < n) {
+                hardening::unpoison(node, block_size_);
+                out[i++] = node;
+                node = node->next;
+            }
+            free_list_ = node;
+#endif
+
+            in_use_ += i - first;
+
+            // Local list ran dry: take back what other threads freed
+            if (i == n || !drain_remote()) break;
+        }
+
+        // Remainder comes straight off the bump region
+        while (i < n) {
+            out[i] = carve();
+            ++i;
+            ++in_use_;
+        }
+    } catch (const std::bad_alloc&) {
+        // All or nothing: hand back what this call took
+        deallocate_bulk(out, i);
+        throw;
+    }
+
+    return n;
+}
+
+void MemoryPool::deallocate_bulk(void** in, std::size_t n) {
+    if (n == 0) return;
+
+#if ALLOC_HARDENING
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(in[i] != nullptr);
+        push_free(static_cast<FreeNode*>(in[i]));
+    }
+#else
+    // Thread the returned blocks into one segment and splice it in
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        assert(in[i] != nullptr);
+        static_cast<FreeNode*>(in[i])->next = static_cast<FreeNode*>(in[i + 1]);
+        poison_free(static_cast<FreeNode*>(in[i]));
+    }
+
+    assert(in[n - 1] != nullptr);
+    static_cast<FreeNode*>(in[n - 1])->next = free_list_;
+    poison_free(static_cast<FreeNode*>(in[n - 1]));
+    free_list_ = static_cast<FreeNode*>(in[0]);
+#endif
+
+    in_use_ -= n;
+}
+
+std::size_t MemoryPool::block_size() const noexcept {
+    return block_size_;
+}
+
+std::size_t MemoryPool::free_bytes() const noexcept {
+    return (chunks_.size() * blocks_per_chunk_ - in_use_) * block_size_;
+}
+
+std::size_t MemoryPool::trim(std::size_t max_retained_bytes) {
+    std::size_t chunk_bytes = block_size_ * blocks_per_chunk_;
+    drain_remote();
+    if (free_bytes() <= max_retained_bytes) return 0;
+
+    // Per-chunk free counts: chunks sorted by address, binary search per node
+    std::vector<char*> sorted(chunks_.size());
+    for (std::size_t i = 0; i < chunks_.size(); ++i)
+        sorted[i] = static_cast<char*>(chunks_[i]);
+    std::sort(sorted.begin(), sorted.end());
+
+    auto owner = [&](void* p) {
+        auto it = std::upper_bound(sorted.begin(), sorted.end(), static_cast<char*>(p));
+        return static_cast<std::size_t>(it - sorted.begin()) - 1;
+    };
+
+    std::vector<std::size_t> free_count(sorted.size(), 0);
+    for (FreeNode* n = free_list_; n; n = next_of(n))
+        ++free_count[owner(n)];
+
+    // Uncarved blocks of the newest chunk are free too
+    std::size_t bump_chunk = sorted.size();
+    if (bump_ != bump_end_) {
+        bump_chunk = owner(bump_);
+        free_count[bump_chunk] += static_cast<std::size_t>(bump_end_ - bump_) / block_size_;
+    }
+
+    // So is every chunk reserve() mapped ahead
+    for (void* spare : spare_chunks_)
+        free_count[owner(spare)] = blocks_per_chunk_;
+
+    // Pick fully free chunks until the retained budget is met
+    std::vector<uint8_t> release(sorted.size(), 0);
+    std::size_t retained = free_bytes();
+    std::size_t released = 0;
+
+    for (std::size_t i = 0; i < sorted.size() && retained > max_retained_bytes; ++i) {
+        if (free_count[i] == blocks_per_chunk_) {
+            release[i] = 1;
+            retained -= chunk_bytes;
+            released += chunk_bytes;
+        }
+    }
+
+    if (released == 0) return 0;
+
+    if (bump_chunk != sorted.size() && release[bump_chunk]) {
+        bump_ = bump_end_ = nullptr;
+    }
+
+    // Rebuild the list without the nodes living in released chunks,
+    // keeping list order
+    FreeNode* head = nullptr;
+    FreeNode* tail = nullptr;
+    for (FreeNode* n = free_list_; n; ) {
+        FreeNode* next = next_of(n);
+        if (!release[owner(n)]) {
+            if (tail) tail->next = hardening::protect_ptr(&tail->next, n);
+            else      head = n;
+            tail = n;
+        }
+        n = next;
+    }
+    if (tail) tail->next = hardening::protect_ptr(&tail->next, static_cast<FreeNode*>(nullptr));
+    free_list_ = head;
+
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        if (!release[i]) continue;
+        trim_chunk(sorted[i]);
+        chunks_.erase(std::find(chunks_.begin(), chunks_.end(), sorted[i]));
+        spare_chunks_.erase(std::remove(spare_chunks_.begin(), spare_chunks_.end(), sorted[i]),
+                            spare_chunks_.end());
+    }
+
+    return released;
+}
+
+void MemoryPool::release_chunk(void* chunk) {
+    std::size_t chunk_size = block_size_ * blocks_per_chunk_;
+    hardening::unpoison(chunk, chunk_size);
+
+    if (flags_ & POOL_PREFAULT) {
+        os_unmap(chunk, chunk_size);
+    } else {
+        ::operator delete(chunk, std::align_val_t{chunk_alignment_});
+    }
+}
+
+void MemoryPool::trim_chunk(void* chunk) {
+    // The C heap may keep a freed span mapped; drop its pages explicitly
+    if (!(flags_ & POOL_PREFAULT)) {
+        os_discard(chunk, block_size_ * blocks_per_chunk_);
+    }
+    release_chunk(chunk);
 }
 
 MemoryPool::~MemoryPool() {
     for (void* chunk : chunks_) {
-        ::operator delete(chunk);
+        release_chunk(chunk);
     }
 }
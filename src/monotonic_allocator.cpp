@@ -1,18 +1,24 @@
 #include "alloc/monotonic_allocator.hpp"
+#include "alloc/hardening.hpp"
 
-MonotonicAllocator::MonotonicAllocator(std::size_t initial_block_size)
-        :initial_block_size_(initial_block_size)
+MonotonicAllocator::MonotonicAllocator(std::size_t initial_block_size, ZeroPolicy zero)
+        :initial_block_size_(initial_block_size), zero_(zero)
     {
         add_block(initial_block_size_);
     }
 
 void MonotonicAllocator::add_block(std::size_t size) {
-    blocks_.push_back(std::make_unique<std::byte[]>(size));
+    // Only the reset policies need a zeroed block; the others skip the memset
+    if (zeroes_on_reset(zero_))
+        blocks_.push_back(std::make_unique<std::byte[]>(size));
+    else
+        blocks_.push_back(std::unique_ptr<std::byte[]>(new std::byte[size]));
     block_sizes_.push_back(size);
 
     start_ = blocks_.back().get();
     current_ = start_;
     end_ = start_ + size;
+    hardening::poison(start_, size);
 }
 
 void* MonotonicAllocator::allocate(std::size_t n, std::size_t alignment) {
@@ -24,10 +30,30 @@ void* MonotonicAllocator::allocate(std::size_t n, std::size_t alignment) {
     }
 
     current_ = aligned + n;
+    hardening::unpoison(aligned, n);
+    if (zero_ == ZeroPolicy::OnAllocate) zero_memory(aligned, n);
     return aligned;
 }
 
 void MonotonicAllocator::reset() noexcept {
+    // Later blocks are freed; block 0 is used up to current_ if it is
+    // still the active one, and possibly to its end otherwise
+    std::size_t used = blocks_.size() == 1
+                     ? static_cast<std::size_t>(current_ - start_)
+                     : block_sizes_[0];
+
+    if (zeroes_on_reset(zero_)) {
+        // Alignment gaps are still poisoned
+        hardening::unpoison(blocks_[0].get(), used);
+        zero_on_reset(zero_, blocks_[0].get(), used);
+    }
+
+    // Everything handed out so far is dead: make stale pointers trap
+    hardening::poison(blocks_[0].get(), used);
+
+    for (std::size_t i = 1; i < blocks_.size(); ++i)
+        hardening::unpoison(blocks_[i].get(), block_sizes_[i]);
+    blocks_.resize(1);
     block_sizes_.resize(1);
 
     start_ = blocks_[0].get();
@@ -52,4 +78,10 @@ std::byte* MonotonicAllocator::align_ptr(std::byte* p, std::size_t alignment) {
     if(misalignment == 0) return p;
 
     return p + (alignment - misalignment);
-}
\ No newline at end of file
+}
+
+MonotonicAllocator::~MonotonicAllocator() {
+    // Hand the heap back unpoisoned
+    for (std::size_t i = 0; i < blocks_.size(); ++i)
+        hardening::unpoison(blocks_[i].get(), block_sizes_[i]);
+}
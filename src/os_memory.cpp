@@ -0,0 +1,95 @@
+#include "alloc/os_memory.hpp"
+#include <cstdint>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+std::size_t os_page_size() noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+    static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return page;
+#else
+    return 4096;
+#endif
+}
+
+std::size_t os_discard(void* p, std::size_t n) noexcept {
+#if defined(MADV_DONTNEED)
+    std::size_t page = os_page_size();
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(p);
+    std::uintptr_t first = (begin + page - 1) & ~(page - 1);
+    std::uintptr_t last  = (begin + n) & ~(page - 1);
+
+    if (last <= first) return 0;
+
+    std::size_t bytes = static_cast<std::size_t>(last - first);
+    if (madvise(reinterpret_cast<void*>(first), bytes, MADV_DONTNEED) != 0)
+        return 0;
+    return bytes;
+#else
+    (void)p;
+    (void)n;
+    return 0;
+#endif
+}
+
+void* os_map(std::size_t n, bool populate) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_POPULATE)
+    if (populate) flags |= MAP_POPULATE;
+#endif
+    void* p = mmap(nullptr, n, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+    return p;
+#else
+    (void)populate;
+    return ::operator new(n, std::align_val_t{os_page_size()}, std::nothrow);
+#endif
+}
+
+void os_unmap(void* p, std::size_t n) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+    munmap(p, n);
+#else
+    (void)n;
+    ::operator delete(p, std::align_val_t{os_page_size()});
+#endif
+}
+
+static std::size_t guarded_span(std::size_t n, std::size_t& usable) noexcept {
+    std::size_t page = os_page_size();
+    usable = (n + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    return (usable + page - 1) & ~(page - 1);
+}
+
+void* os_map_guarded(std::size_t n) noexcept {
+    std::size_t usable;
+    std::size_t pages = guarded_span(n, usable);
+    std::size_t page = os_page_size();
+
+    std::byte* base = static_cast<std::byte*>(os_map(pages + 2 * page, false));
+    if (!base) return nullptr;
+
+#if defined(__unix__) || defined(__APPLE__)
+    if (mprotect(base, page, PROT_NONE) != 0 ||
+        mprotect(base + page + pages, page, PROT_NONE) != 0) {
+        os_unmap(base, pages + 2 * page);
+        return nullptr;
+    }
+#endif
+
+    return base + page + (pages - usable);
+}
+
+void os_unmap_guarded(void* p, std::size_t n) noexcept {
+    std::size_t usable;
+    std::size_t pages = guarded_span(n, usable);
+    std::size_t page = os_page_size();
+
+    std::byte* base = static_cast<std::byte*>(p) + usable - pages - page;
+    os_unmap(base, pages + 2 * page);
+}
@@ -0,0 +1,136 @@
+#include "alloc/percpu_slab_cache.hpp"
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 35)) \
+    && __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define ALLOC_HAVE_RSEQ 1
+#endif
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+PerCpuSlabCache::PerCpuSlabCache(std::size_t object_size,
+                                 std::size_t slab_size,
+                                 SlabCache::Ctor ctor,
+                                 SlabCache::Dtor dtor,
+                                 std::size_t magazine_size)
+    : magazine_size_(magazine_size),
+      depot_(object_size, slab_size, ctor, dtor)
+{
+    assert(magazine_size_ >= 2 && "magazine must hold at least two objects");
+
+#if defined(__linux__)
+    long n = sysconf(_SC_NPROCESSORS_CONF);
+    cpu_count_ = n > 0 ? static_cast<std::size_t>(n) : 1;
+#else
+    cpu_count_ = std::max(1u, std::thread::hardware_concurrency());
+#endif
+
+    magazines_.reset(new Magazine[cpu_count_]);
+    for (std::size_t i = 0; i < cpu_count_; ++i)
+        magazines_[i].objects.reset(new void*[magazine_size_]);
+}
+
+unsigned PerCpuSlabCache::current_cpu() noexcept
+{
+#if defined(ALLOC_HAVE_RSEQ)
+    // glibc registers an rseq area per thread; the kernel keeps cpu_id
+    // current on every return to user space, so this is a plain load
+    if (__rseq_size > 0)
+    {
+        auto* area = reinterpret_cast<const volatile struct rseq*>(
+            static_cast<const char*>(__builtin_thread_pointer()) + __rseq_offset);
+        std::int32_t cpu = static_cast<std::int32_t>(area->cpu_id);
+        if (cpu >= 0) return static_cast<unsigned>(cpu);
+    }
+#endif
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    if (cpu >= 0) return static_cast<unsigned>(cpu);
+#endif
+    return 0;
+}
+
+PerCpuSlabCache::Magazine& PerCpuSlabCache::local_magazine() noexcept
+{
+    return magazines_[current_cpu() % cpu_count_];
+}
+
+void* PerCpuSlabCache::allocate()
+{
+    Magazine& mag = local_magazine();
+    std::lock_guard<SpinLock> guard(mag.lock);
+
+    if (mag.count == 0)
+    {
+        // Refill half a magazine so a following free does not spill at once
+        std::lock_guard<std::mutex> depot(depot_lock_);
+        mag.count = depot_.allocate_bulk(mag.objects.get(), magazine_size_ / 2);
+    }
+
+    return mag.objects[--mag.count];
+}
+
+void PerCpuSlabCache::deallocate(void* ptr)
+{
+    if (!ptr) return;
+
+    Magazine& mag = local_magazine();
+    std::lock_guard<SpinLock> guard(mag.lock);
+
+    if (mag.count == magazine_size_)
+    {
+        // Spill the older half; the depot hands each object back to its slab
+        std::size_t spill = magazine_size_ / 2;
+        {
+            std::lock_guard<std::mutex> depot(depot_lock_);
+            depot_.deallocate_bulk(mag.objects.get(), spill);
+        }
+
+        std::copy(mag.objects.get() + spill, mag.objects.get() + mag.count, mag.objects.get());
+        mag.count -= spill;
+    }
+
+    mag.objects[mag.count++] = ptr;
+}
+
+void PerCpuSlabCache::flush()
+{
+    for (std::size_t i = 0; i < cpu_count_; ++i)
+    {
+        Magazine& mag = magazines_[i];
+        std::lock_guard<SpinLock> guard(mag.lock);
+        if (mag.count == 0) continue;
+
+        std::lock_guard<std::mutex> depot(depot_lock_);
+        depot_.deallocate_bulk(mag.objects.get(), mag.count);
+        mag.count = 0;
+    }
+}
+
+std::size_t PerCpuSlabCache::cached_objects() const
+{
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < cpu_count_; ++i)
+    {
+        std::lock_guard<SpinLock> guard(magazines_[i].lock);
+        total += magazines_[i].count;
+    }
+    return total;
+}
+
+std::size_t PerCpuSlabCache::slab_bytes() const
+{
+    std::lock_guard<std::mutex> depot(depot_lock_);
+    return depot_.slab_bytes();
+}
+
+PerCpuSlabCache::~PerCpuSlabCache()
+{
+    flush();
+}
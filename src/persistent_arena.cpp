@@ -0,0 +1,189 @@
+#include "alloc/persistent_arena.hpp"
+#include "alloc/os_memory.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct PersistentArena::Header {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::uint64_t capacity;     // file size
+    std::uint64_t used;         // bump offset from the start of the file
+    std::uint64_t root;         // offset of the root object, 0 = none
+};
+
+static constexpr std::uint64_t arena_magic = 0x314150434f4c4c41ull;   // "ALLOCPA1"
+static constexpr std::uint32_t arena_version = 1;
+static constexpr std::size_t header_bytes = 64;
+
+static std::size_t round_up(std::size_t n, std::size_t align) noexcept {
+    return (n + align - 1) & ~(align - 1);
+}
+
+[[noreturn]] static void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+PersistentArena::PersistentArena(const char* path, Mode mode, std::size_t capacity)
+    : mode_(mode)
+{
+    static_assert(sizeof(Header) <= header_bytes, "header must fit its reserved space");
+
+#if defined(__unix__) || defined(__APPLE__)
+    int flags = mode == Mode::ReadOnly ? O_RDONLY : O_RDWR;
+    if (mode == Mode::Create) flags |= O_CREAT | O_TRUNC;
+
+    int fd = ::open(path, flags, 0644);
+    if (fd < 0) throw_errno("PersistentArena: open");
+
+    if (mode == Mode::Create) {
+        capacity_ = round_up(std::max(capacity, header_bytes), os_page_size());
+        if (ftruncate(fd, static_cast<off_t>(capacity_)) != 0) {
+            int err = errno;
+            ::close(fd);
+            errno = err;
+            throw_errno("PersistentArena: ftruncate");
+        }
+    } else {
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            errno = err;
+            throw_errno("PersistentArena: fstat");
+        }
+        capacity_ = static_cast<std::size_t>(st.st_size);
+        if (capacity_ < header_bytes) {
+            ::close(fd);
+            throw std::runtime_error("PersistentArena: file too small");
+        }
+    }
+
+    int prot = mode == Mode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    int share = mode == Mode::Private ? MAP_PRIVATE : MAP_SHARED;
+
+    void* p = mmap(nullptr, capacity_, prot, share, fd, 0);
+    int err = errno;
+    ::close(fd);                // the mapping keeps the file alive
+    if (p == MAP_FAILED) {
+        errno = err;
+        throw_errno("PersistentArena: mmap");
+    }
+    base_ = static_cast<std::byte*>(p);
+
+    Header* h = header();
+
+    if (mode == Mode::Create) {
+        h->magic = arena_magic;
+        h->version = arena_version;
+        h->header_size = static_cast<std::uint32_t>(header_bytes);
+        h->capacity = capacity_;
+        h->used = header_bytes;
+        h->root = 0;
+        return;
+    }
+
+    // Reject foreign, truncated or half-written files before anyone
+    // dereferences an offset from them
+    bool ok = h->magic == arena_magic &&
+              h->version == arena_version &&
+              h->header_size == header_bytes &&
+              h->capacity == capacity_ &&
+              h->used >= header_bytes && h->used <= capacity_ &&
+              h->root < h->used;
+    if (!ok) {
+        munmap(base_, capacity_);
+        base_ = nullptr;
+        throw std::runtime_error("PersistentArena: not a valid arena file");
+    }
+#else
+    (void)path;
+    (void)capacity;
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported),
+                            "PersistentArena");
+#endif
+}
+
+PersistentArena::Header* PersistentArena::header() const noexcept {
+    return reinterpret_cast<Header*>(base_);
+}
+
+void* PersistentArena::allocate(std::size_t n, std::size_t alignment) {
+    assert(writable());
+    if (!writable()) return nullptr;
+
+    // The base is page aligned, so aligning the offset aligns the address
+    Header* h = header();
+    std::size_t offset = round_up(static_cast<std::size_t>(h->used), alignment);
+
+    if (offset + n > capacity_ || offset + n < offset) return nullptr;   // Out of space
+
+    h->used = offset + n;
+    return base_ + offset;
+}
+
+void PersistentArena::set_root(const void* p) noexcept {
+    assert(writable());
+    header()->root = p ? offset_of(p) : 0;
+}
+
+void* PersistentArena::root() const noexcept {
+    std::uint64_t off = header()->root;
+    return off ? base_ + off : nullptr;
+}
+
+std::size_t PersistentArena::offset_of(const void* p) const noexcept {
+    assert(p >= base_ && p < base_ + capacity_);
+    return static_cast<std::size_t>(static_cast<const std::byte*>(p) - base_);
+}
+
+void* PersistentArena::at(std::size_t offset) const noexcept {
+    assert(offset < capacity_);
+    return base_ + offset;
+}
+
+bool PersistentArena::sync(bool async) noexcept {
+    if (mode_ != Mode::Create && mode_ != Mode::Open) return false;
+
+#if defined(__unix__) || defined(__APPLE__)
+    std::size_t bytes = round_up(used(), os_page_size());
+    return msync(base_, bytes, async ? MS_ASYNC : MS_SYNC) == 0;
+#else
+    (void)async;
+    return false;
+#endif
+}
+
+std::size_t PersistentArena::used() const noexcept {
+    return static_cast<std::size_t>(header()->used);
+}
+
+std::size_t PersistentArena::remaining() const noexcept {
+    return capacity_ - used();
+}
+
+std::size_t PersistentArena::capacity() const noexcept {
+    return capacity_;
+}
+
+bool PersistentArena::writable() const noexcept {
+    return mode_ != Mode::ReadOnly;
+}
+
+PersistentArena::~PersistentArena() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (base_) munmap(base_, capacity_);
+#endif
+}
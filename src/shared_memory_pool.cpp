@@ -0,0 +1,300 @@
+#include "alloc/shared_memory_pool.hpp"
+#include "alloc/hardening.hpp"
+#include "alloc/os_memory.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Everything shared must be address-free: plain integers and
+// lock-free atomics, no pointers
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared free list needs lock-free 64-bit atomics");
+static_assert(std::atomic<std::int32_t>::is_always_lock_free,
+              "owner table needs lock-free 32-bit atomics");
+
+struct SharedMemoryPool::Header {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t pad;
+    std::uint64_t block_size;
+    std::uint64_t block_count;
+    std::uint64_t next_offset;      // std::atomic<uint32_t>[block_count], index + 1, 0 = end
+    std::uint64_t owner_offset;     // std::atomic<int32_t>[block_count], pid, 0 = free
+    std::uint64_t blocks_offset;
+    std::atomic<std::uint32_t> ready;
+
+    // Own cache line: every allocate / free hits it
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head;   // tag << 32 | (index + 1)
+};
+
+static constexpr std::uint64_t shm_magic = 0x314d48534f4c4c41ull;   // "ALLOSHM1"
+static constexpr std::uint32_t shm_version = 1;
+static constexpr std::uint64_t index_mask = 0xffffffffull;
+
+static std::size_t round_up(std::size_t n, std::size_t align) noexcept {
+    return (n + align - 1) & ~(align - 1);
+}
+
+[[noreturn]] static void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+static std::atomic<std::uint32_t>* next_table(std::byte* base, std::uint64_t offset) noexcept {
+    return reinterpret_cast<std::atomic<std::uint32_t>*>(base + offset);
+}
+
+static std::atomic<std::int32_t>* owner_table(std::byte* base, std::uint64_t offset) noexcept {
+    return reinterpret_cast<std::atomic<std::int32_t>*>(base + offset);
+}
+
+SharedMemoryPool::SharedMemoryPool(const char* name, Mode mode,
+                                   std::size_t block_size, std::size_t block_count,
+                                   SlotLayout layout)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    pid_ = static_cast<std::int32_t>(getpid());
+
+    int fd = mode == Mode::Create ? shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600)
+                                  : shm_open(name, O_RDWR, 0);
+    if (fd < 0) throw_errno("SharedMemoryPool: shm_open");
+
+    std::size_t stride = 0, next_off = 0, owner_off = 0, blocks_off = 0;
+
+    if (mode == Mode::Create) {
+        assert(block_size > 0);
+        assert(block_count > 0 && block_count < index_mask);
+
+        stride = layout_slot_size(block_size, alignof(std::max_align_t), layout);
+        next_off = round_up(sizeof(Header), CACHE_LINE_SIZE);
+        owner_off = round_up(next_off + block_count * sizeof(std::uint32_t), CACHE_LINE_SIZE);
+        blocks_off = round_up(owner_off + block_count * sizeof(std::int32_t), CACHE_LINE_SIZE);
+        size_ = round_up(blocks_off + stride * block_count, os_page_size());
+
+        if (ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+            int err = errno;
+            ::close(fd);
+            shm_unlink(name);
+            errno = err;
+            throw_errno("SharedMemoryPool: ftruncate");
+        }
+    } else {
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            errno = err;
+            throw_errno("SharedMemoryPool: fstat");
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ < sizeof(Header)) {
+            ::close(fd);
+            throw std::runtime_error("SharedMemoryPool: segment too small");
+        }
+    }
+
+    void* p = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int err = errno;
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        if (mode == Mode::Create) shm_unlink(name);
+        errno = err;
+        throw_errno("SharedMemoryPool: mmap");
+    }
+    base_ = static_cast<std::byte*>(p);
+
+    Header* h = header();
+
+    if (mode == Mode::Create) {
+        // A fresh segment is zero-filled: every owner slot reads "free"
+        h->magic = shm_magic;
+        h->version = shm_version;
+        h->block_size = stride;
+        h->block_count = block_count;
+        h->next_offset = next_off;
+        h->owner_offset = owner_off;
+        h->blocks_offset = blocks_off;
+
+        // Thread the list in ascending order, then publish
+        std::atomic<std::uint32_t>* next = next_table(base_, next_off);
+        for (std::size_t i = 0; i < block_count; ++i)
+            next[i].store(i + 1 < block_count ? static_cast<std::uint32_t>(i + 2) : 0,
+                          std::memory_order_relaxed);
+
+        h->head.store(1, std::memory_order_relaxed);
+        h->ready.store(1, std::memory_order_release);
+        return;
+    }
+
+    bool ok = h->ready.load(std::memory_order_acquire) == 1 &&
+              h->magic == shm_magic &&
+              h->version == shm_version &&
+              h->blocks_offset + h->block_size * h->block_count <= size_;
+    if (!ok) {
+        munmap(base_, size_);
+        base_ = nullptr;
+        throw std::runtime_error("SharedMemoryPool: not an initialised pool segment");
+    }
+#else
+    (void)name; (void)mode; (void)block_size; (void)block_count; (void)layout;
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported),
+                            "SharedMemoryPool");
+#endif
+}
+
+SharedMemoryPool::Header* SharedMemoryPool::header() const noexcept {
+    return reinterpret_cast<Header*>(base_);
+}
+
+std::size_t SharedMemoryPool::index_of(const void* ptr) const noexcept {
+    const Header* h = header();
+    std::size_t offset = static_cast<std::size_t>(static_cast<const std::byte*>(ptr) - base_);
+    std::size_t rel = offset - h->blocks_offset;
+
+#if ALLOC_HARDENING
+    if (offset < h->blocks_offset || rel % h->block_size != 0 ||
+        rel / h->block_size >= h->block_count)
+        hardening::fail("SharedMemoryPool: pointer is not a pool block");
+#else
+    assert(offset >= h->blocks_offset && rel % h->block_size == 0);
+    assert(rel / h->block_size < h->block_count);
+#endif
+
+    return rel / h->block_size;
+}
+
+void SharedMemoryPool::push(std::uint32_t index) noexcept {
+    Header* h = header();
+    std::atomic<std::uint32_t>* next = next_table(base_, h->next_offset);
+
+    std::uint64_t head = h->head.load(std::memory_order_relaxed);
+    std::uint64_t fresh;
+    do {
+        next[index].store(static_cast<std::uint32_t>(head & index_mask), std::memory_order_relaxed);
+        fresh = (((head >> 32) + 1) << 32) | (index + 1);
+    } while (!h->head.compare_exchange_weak(head, fresh,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed));
+}
+
+void* SharedMemoryPool::allocate() noexcept {
+    Header* h = header();
+    std::atomic<std::uint32_t>* next = next_table(base_, h->next_offset);
+
+    // The tag changes on every successful CAS, so a head that was
+    // popped and pushed back in between no longer matches
+    std::uint64_t head = h->head.load(std::memory_order_acquire);
+    std::uint64_t fresh;
+    do {
+        if ((head & index_mask) == 0) return nullptr;    // Exhausted
+        std::uint32_t top = static_cast<std::uint32_t>(head & index_mask) - 1;
+        fresh = (((head >> 32) + 1) << 32) | next[top].load(std::memory_order_relaxed);
+    } while (!h->head.compare_exchange_weak(head, fresh,
+                                            std::memory_order_acquire,
+                                            std::memory_order_acquire));
+
+    std::size_t index = static_cast<std::size_t>(head & index_mask) - 1;
+    owner_table(base_, h->owner_offset)[index].store(pid_, std::memory_order_relaxed);
+
+    return base_ + h->blocks_offset + index * h->block_size;
+}
+
+void SharedMemoryPool::deallocate(void* ptr) noexcept {
+    assert(ptr != nullptr);
+
+    Header* h = header();
+    std::size_t index = index_of(ptr);
+
+    // Clearing the owner first keeps recover() from pushing it twice
+    std::int32_t prev = owner_table(base_, h->owner_offset)[index].exchange(0, std::memory_order_relaxed);
+#if ALLOC_HARDENING
+    if (prev == 0) hardening::fail("SharedMemoryPool: double free");
+#else
+    assert(prev != 0 && "double free");
+    (void)prev;
+#endif
+
+    push(static_cast<std::uint32_t>(index));
+}
+
+void SharedMemoryPool::adopt(void* ptr) noexcept {
+    std::size_t index = index_of(ptr);
+    owner_table(base_, header()->owner_offset)[index].store(pid_, std::memory_order_relaxed);
+}
+
+std::size_t SharedMemoryPool::recover() noexcept {
+    std::size_t reclaimed = 0;
+
+#if defined(__unix__) || defined(__APPLE__)
+    Header* h = header();
+    std::atomic<std::int32_t>* owners = owner_table(base_, h->owner_offset);
+
+    for (std::size_t i = 0; i < h->block_count; ++i) {
+        std::int32_t pid = owners[i].load(std::memory_order_relaxed);
+        if (pid == 0 || pid == pid_) continue;
+        if (kill(pid, 0) == 0 || errno != ESRCH) continue;
+
+        // Only one recovering process wins each block
+        if (owners[i].compare_exchange_strong(pid, 0, std::memory_order_relaxed)) {
+            push(static_cast<std::uint32_t>(i));
+            ++reclaimed;
+        }
+    }
+#endif
+
+    return reclaimed;
+}
+
+std::uint64_t SharedMemoryPool::offset_of(const void* ptr) const noexcept {
+    assert(ptr >= base_ && ptr < base_ + size_);
+    return static_cast<std::uint64_t>(static_cast<const std::byte*>(ptr) - base_);
+}
+
+void* SharedMemoryPool::at(std::uint64_t offset) const noexcept {
+    assert(offset < size_);
+    return base_ + offset;
+}
+
+std::size_t SharedMemoryPool::block_size() const noexcept {
+    return static_cast<std::size_t>(header()->block_size);
+}
+
+std::size_t SharedMemoryPool::block_count() const noexcept {
+    return static_cast<std::size_t>(header()->block_count);
+}
+
+std::size_t SharedMemoryPool::free_blocks() const noexcept {
+    const Header* h = header();
+    std::atomic<std::int32_t>* owners = owner_table(base_, h->owner_offset);
+
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < h->block_count; ++i)
+        if (owners[i].load(std::memory_order_relaxed) == 0) ++n;
+    return n;
+}
+
+bool SharedMemoryPool::unlink(const char* name) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+    return shm_unlink(name) == 0;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+SharedMemoryPool::~SharedMemoryPool() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (base_) munmap(base_, size_);
+#endif
+}
@@ -1,4 +1,5 @@
 #include "alloc/slab_allocator.hpp"
+#include <algorithm>
 #include <cassert>
 
 SlabAllocator::SlabAllocator(std::size_t blocks_per_chunk)
@@ -7,7 +8,13 @@ SlabAllocator::SlabAllocator(std::size_t blocks_per_chunk)
     pools_.fill(nullptr);
 }
 
-std::size_t SlabAllocator::class_index(std::size_t size) const {
+std::size_t SlabAllocator::class_index(std::size_t size, std::size_t alignment) const {
+    assert((alignment & (alignment - 1)) == 0 && "alignment must be a power of two");
+
+    // Every block is aligned to its class size, so over-alignment
+    // only means picking a large enough class
+    if (alignment > alignof(std::max_align_t)) size = std::max(size, alignment);
+
     for (std::size_t i = 0; i < NUM_CLASSES; ++i) {
         if (size <= size_classes_[i])
             return i;
@@ -15,26 +22,71 @@ std::size_t SlabAllocator::class_index(std::size_t size) const {
     return NUM_CLASSES; // too large
 }
 
-void* SlabAllocator::allocate(std::size_t size) {
-    std::size_t idx = class_index(size);
-    if (idx == NUM_CLASSES) {
-        return nullptr; // unsupported size
+MemoryPool* SlabAllocator::pool_for(std::size_t idx) {
+    if (!pools_[idx]) {
+        std::size_t size = size_classes_[idx];
+        pools_[idx] = new MemoryPool(size, blocks_per_chunk_, SlotLayout::Packed,
+                                     POOL_DEFAULT, size);
     }
+    return pools_[idx];
+}
 
-    if (!pools_[idx]) {
-        pools_[idx] = new MemoryPool(size_classes_[idx], blocks_per_chunk_);
+void* SlabAllocator::allocate(std::size_t size, std::size_t alignment) {
+    std::size_t idx = class_index(size, alignment);
+    if (idx == NUM_CLASSES) {
+        return nullptr; // unsupported size
     }
 
-    return pools_[idx]->allocate();
+    return pool_for(idx)->allocate();
 }
 
-void SlabAllocator::deallocate(void* ptr, std::size_t size) {
+void SlabAllocator::deallocate(void* ptr, std::size_t size, std::size_t alignment) {
     assert(ptr != nullptr);
-    std::size_t idx = class_index(size);
+    std::size_t idx = class_index(size, alignment);
     assert(idx != NUM_CLASSES);
     pools_[idx]->deallocate(ptr);
 }
 
+std::size_t SlabAllocator::allocate_bulk(std::size_t size, void** out, std::size_t n,
+                                         std::size_t alignment) {
+    std::size_t idx = class_index(size, alignment);
+    if (idx == NUM_CLASSES) {
+        return 0; // unsupported size
+    }
+
+    return pool_for(idx)->allocate_bulk(out, n);
+}
+
+void SlabAllocator::deallocate_bulk(void** in, std::size_t n, std::size_t size,
+                                    std::size_t alignment) {
+    std::size_t idx = class_index(size, alignment);
+    assert(idx != NUM_CLASSES);
+    pools_[idx]->deallocate_bulk(in, n);
+}
+
+std::size_t SlabAllocator::free_bytes() const noexcept {
+    std::size_t total = 0;
+    for (const MemoryPool* pool : pools_) {
+        if (pool) total += pool->free_bytes();
+    }
+    return total;
+}
+
+std::size_t SlabAllocator::trim(std::size_t max_retained_bytes) {
+    std::size_t retained = 0;
+    std::size_t released = 0;
+
+    for (MemoryPool* pool : pools_) {
+        if (!pool) continue;
+
+        std::size_t budget = max_retained_bytes > retained ? max_retained_bytes - retained : 0;
+        released += pool->trim(budget);
+        retained += pool->free_bytes();
+    }
+
+    return released;
+}
+
 SlabAllocator::~SlabAllocator() {
     for (MemoryPool* pool : pools_) {
         delete pool;
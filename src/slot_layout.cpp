@@ -0,0 +1,43 @@
+#include "alloc/slot_layout.hpp"
+#include <algorithm>
+
+static std::size_t round_up(std::size_t n, std::size_t align) noexcept {
+    return (n + align - 1) & ~(align - 1);
+}
+
+static std::size_t next_pow2(std::size_t n) noexcept {
+    std::size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+std::size_t layout_slot_size(std::size_t size,
+                             std::size_t min_align,
+                             SlotLayout layout) noexcept
+{
+    std::size_t slot = round_up(std::max<std::size_t>(size, 1), min_align);
+
+    switch (layout) {
+    case SlotLayout::Packed:
+        return slot;
+
+    case SlotLayout::NoStraddle:
+        // Power-of-two slots below a line tile it exactly, so none crosses
+        // a boundary; larger slots start on a line and touch the minimum
+        // number of lines.
+        if (slot <= CACHE_LINE_SIZE)
+            return next_pow2(slot);
+        return round_up(slot, CACHE_LINE_SIZE);
+
+    case SlotLayout::CacheAligned:
+        return round_up(slot, CACHE_LINE_SIZE);
+    }
+
+    return slot;
+}
+
+std::size_t layout_base_alignment(std::size_t min_align, SlotLayout layout) noexcept {
+    if (layout == SlotLayout::Packed)
+        return min_align;
+    return std::max(min_align, CACHE_LINE_SIZE);
+}
@@ -1,11 +1,27 @@
 #include "alloc/stack_allocator.hpp"
+#include "alloc/hardening.hpp"
+#include "alloc/os_memory.hpp"
+#include <algorithm>
+#include <iterator>
+
+static std::byte* map_region(std::size_t size) {
+    if constexpr (hardening::guard_pages) {
+        void* p = os_map_guarded(size);
+        if (!p) throw std::bad_alloc();
+        return static_cast<std::byte*>(p);
+    } else {
+        return static_cast<std::byte*>(::operator new(size));
+    }
+}
 
 StackAllocator::StackAllocator(std::size_t size) 
     :   size_(size), 
-        start_(static_cast<std::byte*>(::operator new(size))),
+        start_(map_region(size)),
         current_(start_),
         end_(start_ + size) 
-{}
+{
+    hardening::poison(start_, size_);
+}
 
 void* StackAllocator::allocate(std::size_t n, std::size_t alignment) {
     std::byte* aligned = align_ptr(current_, alignment);
@@ -15,15 +31,36 @@ void* StackAllocator::allocate(std::size_t n, std::size_t alignment) {
     }
 
     current_ = aligned + n;
+    hardening::unpoison(aligned, n);
     return aligned;
 }
 
 StackAllocator::Marker StackAllocator::push() const noexcept {
+#if ALLOC_HARDENING
+    try {
+        frames_.push_back(current_);
+    } catch (...) {
+        hardening::fail("StackAllocator: cannot record frame marker");
+    }
+#endif
     return current_;
 }
 
 void StackAllocator::pop(StackAllocator::Marker marker) noexcept {
-    if(marker >= start_ && marker <= end_){
+#if ALLOC_HARDENING
+    // Only a marker of an open frame is valid: a stale marker from an
+    // already popped frame, even one below the top again, or a foreign
+    // pointer is not on the shadow stack. Popping a frame also closes
+    // every frame opened after it.
+    auto open = std::find(frames_.rbegin(), frames_.rend(), marker);
+    if (open == frames_.rend())
+        hardening::fail("StackAllocator: invalid marker passed to pop()");
+    frames_.erase(std::prev(open.base()), frames_.end());
+#endif
+
+    // Markers above the top are ignored
+    if(marker >= start_ && marker <= current_){
+        hardening::poison(marker, static_cast<std::size_t>(current_ - marker));
         current_ = marker;
     }
 }
@@ -40,11 +77,17 @@ std::byte* StackAllocator::align_ptr(std::byte* p, std::size_t alignment) noexce
     std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(p);
     std::size_t misalignment = addr % alignment;
 
-    if(alignment == 0) return p;
+    if(misalignment == 0) return p;
 
     return p + (alignment - misalignment);
 }
 
 StackAllocator::~StackAllocator() {
-    ::operator delete(start_);
+    hardening::unpoison(start_, size_);
+
+    if constexpr (hardening::guard_pages) {
+        os_unmap_guarded(start_, size_);
+    } else {
+        ::operator delete(start_);
+    }
 }
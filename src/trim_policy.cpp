@@ -0,0 +1,49 @@
+#include "alloc/trim_policy.hpp"
+
+BackgroundTrimmer::BackgroundTrimmer(std::chrono::milliseconds interval)
+    : interval_(interval),
+      thread_([this] { run(); })
+{}
+
+void BackgroundTrimmer::add(Task task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+}
+
+void BackgroundTrimmer::wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        woken_ = true;
+    }
+    cv_.notify_one();
+}
+
+void BackgroundTrimmer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+
+    if (thread_.joinable()) thread_.join();
+}
+
+void BackgroundTrimmer::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stopping_) {
+        cv_.wait_for(lock, interval_, [this] { return stopping_ || woken_; });
+        if (stopping_) break;
+        woken_ = false;
+
+        // Tasks take allocator locks; do not hold ours while running them
+        std::vector<Task> tasks = tasks_;
+        lock.unlock();
+        for (Task& task : tasks) task();
+        lock.lock();
+    }
+}
+
+BackgroundTrimmer::~BackgroundTrimmer() {
+    stop();
+}
@@ -0,0 +1,151 @@
+#include "alloc/zeroing.hpp"
+#include "alloc/os_memory.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ALLOC_ZERO_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using ZeroKernel = void (*)(void*, std::size_t) noexcept;
+
+void zero_memset(void* p, std::size_t n) noexcept {
+    std::memset(p, 0, n);
+}
+
+#if defined(ALLOC_ZERO_X86)
+
+// Each kernel stores the unaligned head and tail with memset and the
+// aligned middle with streaming stores, then fences so the zeroes are
+// ordered before anything published afterwards
+
+template <std::size_t Width>
+bool split(void* p, std::size_t n, std::byte*& body, std::size_t& count) noexcept {
+    std::uintptr_t a = reinterpret_cast<std::uintptr_t>(p);
+    std::uintptr_t first = (a + Width - 1) & ~(std::uintptr_t(Width) - 1);
+    std::uintptr_t last = (a + n) & ~(std::uintptr_t(Width) - 1);
+    if (last <= first) return false;
+
+    std::memset(p, 0, first - a);
+    std::memset(reinterpret_cast<void*>(last), 0, a + n - last);
+    body = reinterpret_cast<std::byte*>(first);
+    count = (last - first) / Width;
+    return true;
+}
+
+__attribute__((target("avx512f")))
+void zero_stream_avx512(void* p, std::size_t n) noexcept {
+    std::byte* body;
+    std::size_t count;
+    if (!split<64>(p, n, body, count)) return zero_memset(p, n);
+
+    const __m512i z = _mm512_setzero_si512();
+    for (std::size_t i = 0; i < count; ++i)
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(body + i * 64), z);
+    _mm_sfence();
+}
+
+__attribute__((target("avx2")))
+void zero_stream_avx2(void* p, std::size_t n) noexcept {
+    std::byte* body;
+    std::size_t count;
+    if (!split<32>(p, n, body, count)) return zero_memset(p, n);
+
+    const __m256i z = _mm256_setzero_si256();
+    for (std::size_t i = 0; i < count; ++i)
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(body + i * 32), z);
+    _mm_sfence();
+}
+
+void zero_stream_sse2(void* p, std::size_t n) noexcept {
+    std::byte* body;
+    std::size_t count;
+    if (!split<16>(p, n, body, count)) return zero_memset(p, n);
+
+    const __m128i z = _mm_setzero_si128();
+    for (std::size_t i = 0; i < count; ++i)
+        _mm_stream_si128(reinterpret_cast<__m128i*>(body + i * 16), z);
+    _mm_sfence();
+}
+
+#endif
+
+struct KernelChoice {
+    ZeroKernel fn;
+    const char* name;
+};
+
+KernelChoice pick_kernel() noexcept {
+#if defined(ALLOC_ZERO_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return {zero_stream_avx512, "avx512"};
+    if (__builtin_cpu_supports("avx2"))    return {zero_stream_avx2, "avx2"};
+    return {zero_stream_sse2, "sse2"};
+#else
+    return {zero_memset, "memset"};
+#endif
+}
+
+const KernelChoice& kernel() noexcept {
+    static const KernelChoice choice = pick_kernel();
+    return choice;
+}
+
+constexpr std::size_t STREAM_MAX_THRESHOLD = std::size_t(32) << 20;
+
+std::size_t pick_threshold() noexcept {
+    std::size_t llc = 0;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (l3 > 0) llc = static_cast<std::size_t>(l3);
+#endif
+    if (llc == 0 || llc > STREAM_MAX_THRESHOLD) return STREAM_MAX_THRESHOLD;
+    return llc;
+}
+
+} // namespace
+
+std::size_t zero_stream_threshold() noexcept {
+    static const std::size_t threshold = pick_threshold();
+    return threshold;
+}
+
+void zero_memory(void* p, std::size_t n) noexcept {
+    if (n <= zero_stream_threshold()) {
+        std::memset(p, 0, n);
+        return;
+    }
+    kernel().fn(p, n);
+}
+
+void zero_release(void* p, std::size_t n) noexcept {
+    std::size_t page = os_page_size();
+    std::uintptr_t a = reinterpret_cast<std::uintptr_t>(p);
+    std::uintptr_t first = (a + page - 1) & ~(std::uintptr_t(page) - 1);
+    std::uintptr_t last = (a + n) & ~(std::uintptr_t(page) - 1);
+
+    if (last <= first || os_discard(p, n) != last - first) {
+        zero_memory(p, n);
+        return;
+    }
+
+    std::memset(p, 0, first - a);
+    std::memset(reinterpret_cast<void*>(last), 0, a + n - last);
+}
+
+void zero_on_reset(ZeroPolicy zero, void* p, std::size_t n) noexcept {
+    if (zero == ZeroPolicy::OnReset) zero_memory(p, n);
+    else if (zero == ZeroPolicy::ReleaseOnReset) zero_release(p, n);
+}
+
+const char* zero_kernel_name() noexcept {
+    return kernel().name;
+}